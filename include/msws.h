@@ -44,6 +44,25 @@
 *  4. Improved initialization (seeding) function                           *
 *  5. Made all functions thread-safe by avoiding the use of static vars    *
 *  6. Implemented C++ wrapper class, for convenience                       *
+*  7. Added multi-stream generator that interleaves independent states     *
+*  8. Added SIMD kernels (SSE4.1, AVX2, AVX-512) with runtime dispatch     *
+*  9. Unbiased, division-free bounded values (multiply-shift + rejection)  *
+*  10. Batch bounded values: SIMD multiply-high, compaction and refill     *
+*  11. Added 64-Bit output variant (128-Bit state, one round per value)    *
+*  12. Added counter-based "squares" generator (random access by index)    *
+*  13. Added stream-key generator and per-stream seeding (seed, stream)    *
+*  14. Batch initialization of many contexts, warm-up rounds in SIMD       *
+*  15. Added structure-of-arrays generator bank (one stream per element)   *
+*  16. Full 64-Bit seeds and faster (seed, stream) key expansion           *
+*  17. Added standard UniformRandomBitGenerator engine with block buffer   *
+*  18. Added asynchronous generator (producer thread, lock-free SPSC ring) *
+*  19. Added thread-local generators with unique per-thread streams        *
+*  20. Added lock-free shared generator (counter-based, one fetch_add)     *
+*  21. Parallel buffer fill, output independent of the number of threads   *
+*  22. Multi-threaded binary output in the CLI, with an ordered writer     *
+*  23. Optional zero-copy vmsplice() output into pipes on Linux            *
+*  24. File output through io_uring (optional O_DIRECT), pwrite() fallback *
+*  25. Generator and output threads in the CLI, tunable block size         *
 *                                                                          *
 \**************************************************************************/
 
@@ -52,6 +71,38 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+#include <new>
+#include <iosfwd>
+#if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#define MSWS_CXX11 1
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MSWS_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define MSWS_TARGET(X) __attribute__((target(X)))
+#else
+#define MSWS_TARGET(X)
+#endif
 
 #ifdef __cplusplus
 namespace msws { namespace impl {
@@ -59,6 +110,23 @@ namespace msws { namespace impl {
 
 typedef uint64_t msws_t[3];
 
+inline static uint64_t msws_mul128(const uint64_t a, const uint64_t b, uint64_t *const hi)
+{
+#if defined(__SIZEOF_INT128__)
+	const __uint128_t r = ((__uint128_t)a) * b;
+	*hi = (uint64_t)(r >> 64U);
+	return (uint64_t)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return _umul128(a, b, hi);
+#else
+	const uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF), hi_lo = (a >> 32U) * (b & 0xFFFFFFFF);
+	const uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32U), hi_hi = (a >> 32U) * (b >> 32U);
+	const uint64_t cross = (lo_lo >> 32U) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	*hi = hi_hi + (hi_lo >> 32U) + (cross >> 32U);
+	return (cross << 32U) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
 inline static uint32_t msws_uint32(msws_t ctx)
 {
 	ctx[0] *= ctx[0]; ctx[0] += (ctx[1] += ctx[2]);
@@ -91,29 +159,143 @@ static inline uint32_t msws_uint32_max(msws_t ctx, const uint32_t max)
 		: (msws_uint32(ctx) / (UINT32_MAX / max + 1U));
 }
 
+inline static uint32_t msws_uint32_bounded(msws_t ctx, const uint32_t max)
+{
+	uint64_t m = ((uint64_t)msws_uint32(ctx)) * max;
+	if (((uint32_t)m) < max)
+	{
+		const uint32_t threshold = (0U - max) % max;
+		while (((uint32_t)m) < threshold)
+		{
+			m = ((uint64_t)msws_uint32(ctx)) * max;
+		}
+	}
+	return (uint32_t)(m >> 32U);
+}
+
 inline static uint64_t msws_uint64(msws_t ctx)
 {
-	return (((uint64_t)msws_uint32(ctx)) << 32U) | msws_uint32(ctx);
+	const uint64_t hi = msws_uint32(ctx);
+	return (hi << 32U) | msws_uint32(ctx);
+}
+
+inline static uint32_t msws_round(uint64_t *const x, uint64_t *const w, const uint64_t s)
+{
+	*x *= *x; *x += (*w += s);
+	return (uint32_t)(*x = (*x >> 32) | (*x << 32));
 }
 
 inline static void msws_bytes(msws_t ctx, uint8_t *buffer, size_t len)
 {
-	if (((len & 3U) == 0U) && ((((uintptr_t)buffer) & 3U) == 0U))
+	uint64_t x = ctx[0], w = ctx[1];
+	const uint64_t s = ctx[2];
+	for (; len >= 8U; len -= 8U, buffer += 8U)
 	{
-		uint32_t *ptr = (uint32_t*)buffer;
-		for (len >>= 2U; len; --len)
-		{
-			*ptr++ = msws_uint32(ctx);
-		}
+		uint32_t words[2U];
+		words[0U] = msws_round(&x, &w, s);
+		words[1U] = msws_round(&x, &w, s);
+		memcpy(buffer, words, sizeof(words));
+	}
+	if (len >= 4U)
+	{
+		const uint32_t word = msws_round(&x, &w, s);
+		memcpy(buffer, &word, sizeof(uint32_t));
+		buffer += 4U; len -= 4U;
 	}
-	else
+	if (len)
 	{
-		uint32_t tmp;
-		for(size_t sft = 0U; len; --len, sft = (sft + 1U) & 3U)
+		uint32_t tmp = msws_round(&x, &w, s);
+		for (; len; --len, tmp >>= 8U)
 		{
-			*buffer++ = (uint8_t)(sft ? (tmp >>= 8U) : (tmp = msws_uint32(ctx)));
+			*buffer++ = (uint8_t)tmp;
 		}
 	}
+	ctx[0] = x; ctx[1] = w;
+}
+
+inline static void msws_uint32_array(msws_t ctx, uint32_t *out, size_t count)
+{
+	uint64_t x = ctx[0], w = ctx[1];
+	const uint64_t s = ctx[2];
+	for (; count >= 4U; count -= 4U, out += 4U)
+	{
+		out[0U] = msws_round(&x, &w, s);
+		out[1U] = msws_round(&x, &w, s);
+		out[2U] = msws_round(&x, &w, s);
+		out[3U] = msws_round(&x, &w, s);
+	}
+	for (; count; --count)
+	{
+		*out++ = msws_round(&x, &w, s);
+	}
+	ctx[0] = x; ctx[1] = w;
+}
+
+inline static void msws_uint64_array(msws_t ctx, uint64_t *out, size_t count)
+{
+	uint64_t x = ctx[0], w = ctx[1];
+	const uint64_t s = ctx[2];
+	for (; count >= 2U; count -= 2U, out += 2U)
+	{
+		const uint64_t hi0 = msws_round(&x, &w, s);
+		out[0U] = (hi0 << 32U) | msws_round(&x, &w, s);
+		const uint64_t hi1 = msws_round(&x, &w, s);
+		out[1U] = (hi1 << 32U) | msws_round(&x, &w, s);
+	}
+	if (count)
+	{
+		const uint64_t hi = msws_round(&x, &w, s);
+		*out = (hi << 32U) | msws_round(&x, &w, s);
+	}
+	ctx[0] = x; ctx[1] = w;
+}
+
+#define MSWS_NT_CHUNK 4096U
+
+#if defined(MSWS_X86)
+MSWS_TARGET("sse2") inline static void msws_store_nt(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	const size_t head = (16U - (((uintptr_t)dst) & 15U)) & 15U;
+	if (head >= len)
+	{
+		memcpy(dst, src, len);
+		return;
+	}
+	memcpy(dst, src, head);
+	dst += head; src += head; len -= head;
+	for (; len >= 16U; len -= 16U, dst += 16U, src += 16U)
+	{
+		_mm_stream_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+	}
+	memcpy(dst, src, len);
+}
+
+inline static void msws_store_nt_fence(void)
+{
+	_mm_sfence();
+}
+#else
+inline static void msws_store_nt(uint8_t *const dst, const uint8_t *const src, const size_t len)
+{
+	memcpy(dst, src, len);
+}
+
+inline static void msws_store_nt_fence(void)
+{
+}
+#endif
+
+inline static void msws_bytes_nt(msws_t ctx, uint8_t *buffer, size_t len)
+{
+	uint8_t stage[MSWS_NT_CHUNK];
+	while (len)
+	{
+		const size_t count = (len < MSWS_NT_CHUNK) ? len : MSWS_NT_CHUNK;
+		msws_bytes(ctx, stage, count);
+		msws_store_nt(buffer, stage, count);
+		buffer += count; len -= count;
+	}
+	msws_store_nt_fence();
 }
 
 inline static void msws_init(msws_t ctx, const uint32_t seed)
@@ -126,39 +308,1968 @@ inline static void msws_init(msws_t ctx, const uint32_t seed)
 	}
 }
 
-#ifdef __cplusplus
-} //impl
+/*
+ * 64-Bit output variant: x, w and s are 128-Bit values, stored as (lo, hi)
+ * word pairs, and each round yields the middle 64 bits of the square:
+ *
+ * x *= x; x += (w += s); return x = (x>>64) | (x<<64);
+ *
+ * This is one squaring per 64-Bit value, rather than two chained 32-Bit
+ * rounds. The pairs are updated with explicit carries, so the sequence is
+ * the same whether or not the compiler provides a native 128-Bit type.
+ */
 
-class rng
+typedef uint64_t msws64_t[6];
+
+inline static uint64_t msws64_round(uint64_t *const x, uint64_t *const w, const uint64_t *const s)
 {
-public:
-	inline rng(const uint32_t seed)
+	uint64_t hi;
+	uint64_t lo = msws_mul128(x[0], x[0], &hi);
+	hi += (x[0] * x[1]) << 1U;
+	w[0] += s[0]; w[1] += s[1] + (w[0] < s[0]);
+	lo += w[0]; hi += w[1] + (lo < w[0]);
+	x[0] = hi; x[1] = lo;
+	return hi;
+}
+
+inline static uint64_t msws64_uint64(msws64_t ctx)
+{
+	return msws64_round(ctx, ctx + 2U, ctx + 4U);
+}
+
+inline static uint64_t msws64_uint64_bounded(msws64_t ctx, const uint64_t max)
+{
+	uint64_t hi, lo = msws_mul128(msws64_uint64(ctx), max, &hi);
+	if (lo < max)
 	{
-		impl::msws_init(m_ctx, seed);
+		const uint64_t threshold = (UINT64_C(0) - max) % max;
+		while (lo < threshold)
+		{
+			lo = msws_mul128(msws64_uint64(ctx), max, &hi);
+		}
 	}
+	return hi;
+}
 
-	inline uint32_t uint32(void)
+inline static void msws64_uint64_array(msws64_t ctx, uint64_t *out, size_t count)
+{
+	uint64_t x[2U] = { ctx[0], ctx[1] }, w[2U] = { ctx[2], ctx[3] };
+	const uint64_t s[2U] = { ctx[4], ctx[5] };
+	for (; count >= 2U; count -= 2U, out += 2U)
 	{
-		return impl::msws_uint32(m_ctx);
+		out[0U] = msws64_round(x, w, s);
+		out[1U] = msws64_round(x, w, s);
+	}
+	if (count)
+	{
+		*out = msws64_round(x, w, s);
 	}
+	ctx[0] = x[0]; ctx[1] = x[1]; ctx[2] = w[0]; ctx[3] = w[1];
+}
 
-	inline uint32_t uint32(const uint32_t max)
+inline static void msws64_bytes(msws64_t ctx, uint8_t *buffer, size_t len)
+{
+	uint64_t x[2U] = { ctx[0], ctx[1] }, w[2U] = { ctx[2], ctx[3] };
+	const uint64_t s[2U] = { ctx[4], ctx[5] };
+	for (; len >= 8U; len -= 8U, buffer += 8U)
 	{
-		return impl::msws_uint32_max(m_ctx, max);
+		const uint64_t word = msws64_round(x, w, s);
+		memcpy(buffer, &word, sizeof(uint64_t));
+	}
+	if (len)
+	{
+		uint64_t tmp = msws64_round(x, w, s);
+		for (; len; --len, tmp >>= 8U)
+		{
+			*buffer++ = (uint8_t)tmp;
+		}
 	}
+	ctx[0] = x[0]; ctx[1] = x[1]; ctx[2] = w[0]; ctx[3] = w[1];
+}
 
-	inline uint64_t uint64(void)
+inline static void msws64_init(msws64_t ctx, const uint32_t seed)
+{
+	ctx[0] = ctx[1] = ctx[2] = ctx[3] = UINT64_C(0);
+	ctx[4] = (((uint64_t)seed) << 1U) + 0xB5AD4ECEDA1CE2A9;
+	ctx[5] = 0x278C5A4D8419FE6B;
+	for (int i = 0; i < 13; ++i)
 	{
-		return impl::msws_uint64(m_ctx);
+		volatile uint64_t q = msws64_uint64(ctx);
 	}
+}
 
-	inline void bytes(uint8_t *const buffer, const size_t len)
+/*
+ * Multi-stream generator: 32 independent MSWS states ("lanes"), stepped in
+ * lock-step. Each round produces one 32-Bit word per lane, in lane order,
+ * so word i of the output stream comes from lane (i % 32), round (i / 32).
+ * Byte sequences are the words stored in native (little-endian) order and
+ * uint64 values take the first word as the upper half. All kernels below
+ * produce exactly this sequence; lane 0 equals msws_init() for the seed.
+ */
+
+#define MSWS_X32_LANES 32U
+
+typedef struct
+{
+	uint64_t x[MSWS_X32_LANES], w[MSWS_X32_LANES], s[MSWS_X32_LANES];
+	uint32_t buff[MSWS_X32_LANES];
+	size_t pos;
+}
+msws_x32_t;
+
+inline static void msws_x32_step(msws_x32_t *const ctx, uint32_t *const out)
+{
+	for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
 	{
-		return impl::msws_bytes(m_ctx, buffer, len);
+		ctx->x[i] *= ctx->x[i]; ctx->x[i] += (ctx->w[i] += ctx->s[i]);
+		out[i] = (uint32_t)(ctx->x[i] = (ctx->x[i] >> 32) | (ctx->x[i] << 32));
 	}
+}
 
-private:
-	impl::msws_t m_ctx;
+inline static void msws_x32_bytes_scalar(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	uint64_t x[MSWS_X32_LANES], w[MSWS_X32_LANES], s[MSWS_X32_LANES];
+	memcpy(x, ctx->x, sizeof(x));
+	memcpy(w, ctx->w, sizeof(w));
+	memcpy(s, ctx->s, sizeof(s));
+	for (; len >= (MSWS_X32_LANES << 2U); len -= (MSWS_X32_LANES << 2U), buffer += (MSWS_X32_LANES << 2U))
+	{
+		for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+		{
+			x[i] *= x[i]; x[i] += (w[i] += s[i]); x[i] = (x[i] >> 32) | (x[i] << 32);
+			const uint32_t value = (uint32_t)x[i];
+			memcpy(buffer + (i << 2U), &value, sizeof(uint32_t));
+		}
+	}
+	memcpy(ctx->x, x, sizeof(x));
+	memcpy(ctx->w, w, sizeof(w));
+	if (len)
+	{
+		msws_x32_step(ctx, ctx->buff);
+		memcpy(buffer, ctx->buff, len);
+		ctx->pos = (len + 3U) >> 2U;
+	}
+}
+
+#if defined(MSWS_X86)
+MSWS_TARGET("sse4.1") inline static __m128i msws_sse41_sqr(const __m128i x)
+{
+	const __m128i cross = _mm_mul_epu32(x, _mm_srli_epi64(x, 32));
+	return _mm_add_epi64(_mm_mul_epu32(x, x), _mm_slli_epi64(cross, 33));
+}
+
+MSWS_TARGET("sse4.1") inline static void msws_x32_bytes_sse41(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	__m128i x[16U], w[16U], s[16U];
+	for (size_t r = 0U; r < 16U; ++r)
+	{
+		x[r] = _mm_loadu_si128((const __m128i*)(ctx->x + (r << 1U)));
+		w[r] = _mm_loadu_si128((const __m128i*)(ctx->w + (r << 1U)));
+		s[r] = _mm_loadu_si128((const __m128i*)(ctx->s + (r << 1U)));
+	}
+	for (;;)
+	{
+		uint8_t *const dst = (len < (MSWS_X32_LANES << 2U)) ? ((uint8_t*)ctx->buff) : buffer;
+		for (size_t r = 0U; r < 16U; r += 2U)
+		{
+			w[r] = _mm_add_epi64(w[r], s[r]);
+			w[r + 1U] = _mm_add_epi64(w[r + 1U], s[r + 1U]);
+			x[r] = _mm_shuffle_epi32(_mm_add_epi64(msws_sse41_sqr(x[r]), w[r]), 0xB1);
+			x[r + 1U] = _mm_shuffle_epi32(_mm_add_epi64(msws_sse41_sqr(x[r + 1U]), w[r + 1U]), 0xB1);
+			const __m128 packed = _mm_shuffle_ps(_mm_castsi128_ps(x[r]), _mm_castsi128_ps(x[r + 1U]), 0x88);
+			_mm_storeu_si128((__m128i*)(dst + (r << 3U)), _mm_castps_si128(packed));
+		}
+		if (len <= (MSWS_X32_LANES << 2U))
+		{
+			if (dst != buffer)
+			{
+				memcpy(buffer, ctx->buff, len);
+				ctx->pos = (len + 3U) >> 2U;
+			}
+			break;
+		}
+		buffer += (MSWS_X32_LANES << 2U);
+		len -= (MSWS_X32_LANES << 2U);
+	}
+	for (size_t r = 0U; r < 16U; ++r)
+	{
+		_mm_storeu_si128((__m128i*)(ctx->x + (r << 1U)), x[r]);
+		_mm_storeu_si128((__m128i*)(ctx->w + (r << 1U)), w[r]);
+	}
+}
+
+MSWS_TARGET("avx2") inline static __m256i msws_avx2_sqr(const __m256i x)
+{
+	const __m256i cross = _mm256_mul_epu32(x, _mm256_srli_epi64(x, 32));
+	return _mm256_add_epi64(_mm256_mul_epu32(x, x), _mm256_slli_epi64(cross, 33));
+}
+
+MSWS_TARGET("avx2") inline static void msws_x32_bytes_avx2(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	__m256i x[8U], w[8U], s[8U];
+	for (size_t r = 0U; r < 8U; ++r)
+	{
+		x[r] = _mm256_loadu_si256((const __m256i*)(ctx->x + (r << 2U)));
+		w[r] = _mm256_loadu_si256((const __m256i*)(ctx->w + (r << 2U)));
+		s[r] = _mm256_loadu_si256((const __m256i*)(ctx->s + (r << 2U)));
+	}
+	for (;;)
+	{
+		uint8_t *const dst = (len < (MSWS_X32_LANES << 2U)) ? ((uint8_t*)ctx->buff) : buffer;
+		for (size_t r = 0U; r < 8U; r += 2U)
+		{
+			w[r] = _mm256_add_epi64(w[r], s[r]);
+			w[r + 1U] = _mm256_add_epi64(w[r + 1U], s[r + 1U]);
+			x[r] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(x[r]), w[r]), 0xB1);
+			x[r + 1U] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(x[r + 1U]), w[r + 1U]), 0xB1);
+			const __m256 packed = _mm256_shuffle_ps(_mm256_castsi256_ps(x[r]), _mm256_castsi256_ps(x[r + 1U]), 0x88);
+			_mm256_storeu_si256((__m256i*)(dst + (r << 4U)), _mm256_permute4x64_epi64(_mm256_castps_si256(packed), 0xD8));
+		}
+		if (len <= (MSWS_X32_LANES << 2U))
+		{
+			if (dst != buffer)
+			{
+				memcpy(buffer, ctx->buff, len);
+				ctx->pos = (len + 3U) >> 2U;
+			}
+			break;
+		}
+		buffer += (MSWS_X32_LANES << 2U);
+		len -= (MSWS_X32_LANES << 2U);
+	}
+	for (size_t r = 0U; r < 8U; ++r)
+	{
+		_mm256_storeu_si256((__m256i*)(ctx->x + (r << 2U)), x[r]);
+		_mm256_storeu_si256((__m256i*)(ctx->w + (r << 2U)), w[r]);
+	}
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw") inline static void msws_x32_bytes_avx512(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	__m512i x[4U], w[4U], s[4U];
+	for (size_t r = 0U; r < 4U; ++r)
+	{
+		x[r] = _mm512_loadu_si512(ctx->x + (r << 3U));
+		w[r] = _mm512_loadu_si512(ctx->w + (r << 3U));
+		s[r] = _mm512_loadu_si512(ctx->s + (r << 3U));
+	}
+	const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+	for (;;)
+	{
+		__m512i out[2U];
+		for (size_t r = 0U; r < 4U; ++r)
+		{
+			w[r] = _mm512_add_epi64(w[r], s[r]);
+			x[r] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(x[r], x[r]), w[r]), 32);
+		}
+		out[0U] = _mm512_permutex2var_epi32(x[0U], even, x[1U]);
+		out[1U] = _mm512_permutex2var_epi32(x[2U], even, x[3U]);
+		if (len < (MSWS_X32_LANES << 2U))
+		{
+			_mm512_mask_storeu_epi8(buffer, (len >= 64U) ? ~UINT64_C(0) : ((UINT64_C(1) << len) - 1U), out[0U]);
+			_mm512_mask_storeu_epi8(buffer + 64U, (len > 64U) ? ((UINT64_C(1) << (len - 64U)) - 1U) : UINT64_C(0), out[1U]);
+			_mm512_storeu_si512(ctx->buff, out[0U]);
+			_mm512_storeu_si512(ctx->buff + 16U, out[1U]);
+			ctx->pos = (len + 3U) >> 2U;
+			break;
+		}
+		_mm512_storeu_si512(buffer, out[0U]);
+		_mm512_storeu_si512(buffer + 64U, out[1U]);
+		buffer += (MSWS_X32_LANES << 2U);
+		if (!(len -= (MSWS_X32_LANES << 2U)))
+		{
+			break;
+		}
+	}
+	for (size_t r = 0U; r < 4U; ++r)
+	{
+		_mm512_storeu_si512(ctx->x + (r << 3U), x[r]);
+		_mm512_storeu_si512(ctx->w + (r << 3U), w[r]);
+	}
+}
+#endif
+
+inline static size_t msws_bounded_tail(uint32_t *const data, size_t i, size_t k, const size_t len, const uint32_t max, const uint32_t threshold)
+{
+	for (; i < len; ++i)
+	{
+		const uint64_t m = ((uint64_t)data[i]) * max;
+		if (((uint32_t)m) >= threshold)
+		{
+			data[k++] = (uint32_t)(m >> 32U);
+		}
+	}
+	return k;
+}
+
+inline static size_t msws_bounded_scalar(uint32_t *const data, const size_t len, const uint32_t max, const uint32_t threshold)
+{
+	return msws_bounded_tail(data, 0U, 0U, len, max, threshold);
+}
+
+#if defined(MSWS_X86)
+MSWS_TARGET("sse4.1") inline static size_t msws_bounded_sse41(uint32_t *const data, const size_t len, const uint32_t max, const uint32_t threshold)
+{
+	const __m128i vmax = _mm_set1_epi32((int)max), vthr = _mm_set1_epi32((int)threshold);
+	size_t i = 0U, k = 0U;
+	for (; i + 4U <= len; i += 4U)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+		const __m128i lo = _mm_mullo_epi32(v, vmax);
+		const __m128i even = _mm_mul_epu32(v, vmax), odd = _mm_mul_epu32(_mm_srli_epi64(v, 32), vmax);
+		const __m128i hi = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+		const int accept = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_max_epu32(lo, vthr), lo)));
+		if (accept == 0xF)
+		{
+			_mm_storeu_si128((__m128i*)(data + k), hi);
+			k += 4U;
+			continue;
+		}
+		uint32_t tmp[4U];
+		_mm_storeu_si128((__m128i*)tmp, hi);
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			if (accept & (1 << j))
+			{
+				data[k++] = tmp[j];
+			}
+		}
+	}
+	return msws_bounded_tail(data, i, k, len, max, threshold);
+}
+
+MSWS_TARGET("avx2") inline static size_t msws_bounded_avx2(uint32_t *const data, const size_t len, const uint32_t max, const uint32_t threshold)
+{
+	const __m256i vmax = _mm256_set1_epi32((int)max), vthr = _mm256_set1_epi32((int)threshold);
+	size_t i = 0U, k = 0U;
+	for (; i + 8U <= len; i += 8U)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+		const __m256i lo = _mm256_mullo_epi32(v, vmax);
+		const __m256i even = _mm256_mul_epu32(v, vmax), odd = _mm256_mul_epu32(_mm256_srli_epi64(v, 32), vmax);
+		const __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+		const int accept = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_max_epu32(lo, vthr), lo)));
+		if (accept == 0xFF)
+		{
+			_mm256_storeu_si256((__m256i*)(data + k), hi);
+			k += 8U;
+			continue;
+		}
+		uint32_t tmp[8U];
+		_mm256_storeu_si256((__m256i*)tmp, hi);
+		for (size_t j = 0U; j < 8U; ++j)
+		{
+			if (accept & (1 << j))
+			{
+				data[k++] = tmp[j];
+			}
+		}
+	}
+	return msws_bounded_tail(data, i, k, len, max, threshold);
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw,popcnt") inline static size_t msws_bounded_avx512(uint32_t *const data, const size_t len, const uint32_t max, const uint32_t threshold)
+{
+	const __m512i vmax = _mm512_set1_epi32((int)max), vthr = _mm512_set1_epi32((int)threshold);
+	size_t i = 0U, k = 0U;
+	for (; i < len; i += 16U)
+	{
+		const __mmask16 valid = ((len - i) >= 16U) ? ((__mmask16)0xFFFF) : ((__mmask16)((1U << (len - i)) - 1U));
+		const __m512i v = _mm512_maskz_loadu_epi32(valid, data + i);
+		const __m512i lo = _mm512_mullo_epi32(v, vmax);
+		const __m512i even = _mm512_mul_epu32(v, vmax), odd = _mm512_mul_epu32(_mm512_srli_epi64(v, 32), vmax);
+		const __m512i hi = _mm512_mask_blend_epi32((__mmask16)0xAAAA, _mm512_srli_epi64(even, 32), odd);
+		const __mmask16 accept = _mm512_mask_cmpge_epu32_mask(valid, lo, vthr);
+		const uint32_t count = (uint32_t)_mm_popcnt_u32(accept);
+		_mm512_mask_storeu_epi32(data + k, (__mmask16)((1U << count) - 1U), _mm512_maskz_compress_epi32(accept, hi));
+		k += count;
+	}
+	return k;
+}
+#endif
+
+/*
+ * Counter-based generator ("squares"): value n of a stream is a function of
+ * n and a key only, so any position can be computed directly and disjoint
+ * counter ranges can be generated independently. The key should be an odd
+ * constant with well-mixed bits, like the MSWS constant s.
+ */
+
+#define MSWS_SQUARES_KEY 0x7A3C5E91D4F2B6E9
+
+inline static uint32_t msws_squares32(const uint64_t ctr, const uint64_t key)
+{
+	uint64_t x, y, z;
+	y = x = ctr * key; z = y + key;
+	x = x * x + y; x = (x >> 32) | (x << 32);
+	x = x * x + z; x = (x >> 32) | (x << 32);
+	x = x * x + y; x = (x >> 32) | (x << 32);
+	return (uint32_t)((x * x + z) >> 32);
+}
+
+inline static uint64_t msws_squares64(const uint64_t ctr, const uint64_t key)
+{
+	uint64_t t, x, y, z;
+	y = x = ctr * key; z = y + key;
+	x = x * x + y; x = (x >> 32) | (x << 32);
+	x = x * x + z; x = (x >> 32) | (x << 32);
+	x = x * x + y; x = (x >> 32) | (x << 32);
+	t = x = x * x + z; x = (x >> 32) | (x << 32);
+	return t ^ ((x * x + y) >> 32);
+}
+
+/*
+ * Stream keys: odd 64-Bit constants built the way the original MSWS keys
+ * are, i.e. each 32-Bit half consists of eight distinct non-zero hex digits
+ * (with an odd lowest digit). The digits are drawn from the squares
+ * generator, so key n of a set is computed directly from n. A seed first
+ * selects the key of its set, which then numbers the individual streams.
+ */
+
+inline static uint32_t msws_key_half(uint64_t r0, const uint64_t r1, const int odd)
+{
+	uint8_t digits[15U];
+	uint32_t half = 0U;
+	for (uint32_t i = 0U; i < 15U; ++i)
+	{
+		digits[i] = (uint8_t)(i + 1U);
+	}
+	for (uint32_t i = 0U; i < 8U; ++i, r0 >>= 16U)
+	{
+		const uint32_t r = (uint32_t)(((i < 4U) ? r0 : (r1 >> ((i - 4U) << 4U))) & 0xFFFFU);
+		const uint32_t j = (odd && (!i)) ? (((r * 8U) >> 16U) << 1U) : (i + ((r * (15U - i)) >> 16U));
+		const uint8_t tmp = digits[i]; digits[i] = digits[j]; digits[j] = tmp;
+		half |= ((uint32_t)digits[i]) << (i << 2U);
+	}
+	return half;
+}
+
+inline static uint64_t msws_key_next(const uint64_t key, const uint64_t index)
+{
+	const uint64_t ctr = index << 2U;
+	const uint32_t lo = msws_key_half(msws_squares64(ctr, key), msws_squares64(ctr + 1U, key), 1);
+	return (((uint64_t)msws_key_half(msws_squares64(ctr + 2U, key), msws_squares64(ctr + 3U, key), 0)) << 32U) | lo;
+}
+
+inline static uint64_t msws_key(const uint64_t seed, const uint64_t stream)
+{
+	return msws_key_next(msws_key_next(MSWS_SQUARES_KEY, seed), stream);
+}
+
+inline static void msws_keys(const uint64_t seed, uint64_t first, uint64_t *out, size_t count)
+{
+	const uint64_t key = msws_key_next(MSWS_SQUARES_KEY, seed);
+	for (; count; --count)
+	{
+		*out++ = msws_key_next(key, first++);
+	}
+}
+
+inline static void msws_init_stream(msws_t ctx, const uint64_t seed, const uint64_t stream)
+{
+	ctx[0] = UINT64_C(0); ctx[1] = UINT64_C(0);
+	ctx[2] = msws_key(seed, stream);
+	for (int i = 0; i < 13; ++i)
+	{
+		volatile uint32_t q = msws_uint32(ctx);
+	}
+}
+
+/*
+ * 64-Bit seeds: values below 2^32 give the same state as msws_init(), any
+ * larger seed is expanded into x, w and s by the squares generator.
+ */
+
+inline static void msws_init_seed64(msws_t ctx, const uint64_t seed)
+{
+	if (seed <= UINT64_C(0xFFFFFFFF))
+	{
+		msws_init(ctx, (uint32_t)seed);
+		return;
+	}
+	ctx[0] = msws_squares64(seed, UINT64_C(0x9E3D5A7B41C8F26D));
+	ctx[1] = msws_squares64(seed, UINT64_C(0xC58A1F3E7D2B9461));
+	ctx[2] = msws_squares64(seed, UINT64_C(0x6B2F84D1A9C35E7F)) | UINT64_C(1);
+	if (!(ctx[2] >> 32U))
+	{
+		ctx[2] |= UINT64_C(0xB5AD4ECE00000000);
+	}
+}
+
+inline static void msws_squares32_scalar(const uint64_t key, uint64_t ctr, uint32_t *out, size_t count)
+{
+	for (; count; --count)
+	{
+		*out++ = msws_squares32(ctr++, key);
+	}
+}
+
+#if defined(MSWS_X86)
+MSWS_TARGET("avx2") inline static void msws_squares32_avx2(const uint64_t key, uint64_t ctr, uint32_t *out, size_t count)
+{
+	__m256i y[4U];
+	const __m256i k = _mm256_set1_epi64x((long long)key), step = _mm256_set1_epi64x((long long)(key << 4U));
+	for (size_t r = 0U; r < 4U; ++r)
+	{
+		const uint64_t base = ctr + (r << 2U);
+		y[r] = _mm256_set_epi64x((long long)((base + 3U) * key), (long long)((base + 2U) * key), (long long)((base + 1U) * key), (long long)(base * key));
+	}
+	for (; count >= 16U; count -= 16U, out += 16U, ctr += 16U)
+	{
+		__m256i x[4U];
+		for (size_t r = 0U; r < 4U; ++r)
+		{
+			const __m256i z = _mm256_add_epi64(y[r], k);
+			x[r] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(y[r]), y[r]), 0xB1);
+			x[r] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(x[r]), z), 0xB1);
+			x[r] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(x[r]), y[r]), 0xB1);
+			x[r] = _mm256_add_epi64(msws_avx2_sqr(x[r]), z);
+			y[r] = _mm256_add_epi64(y[r], step);
+		}
+		for (size_t r = 0U; r < 4U; r += 2U)
+		{
+			const __m256 hi = _mm256_shuffle_ps(_mm256_castsi256_ps(x[r]), _mm256_castsi256_ps(x[r + 1U]), 0xDD);
+			_mm256_storeu_si256((__m256i*)(out + (r << 2U)), _mm256_permute4x64_epi64(_mm256_castps_si256(hi), 0xD8));
+		}
+	}
+	msws_squares32_scalar(key, ctr, out, count);
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw") inline static void msws_squares32_avx512(const uint64_t key, uint64_t ctr, uint32_t *out, size_t count)
+{
+	__m512i y[4U];
+	const __m512i k = _mm512_set1_epi64((long long)key), step = _mm512_set1_epi64((long long)(key << 5U));
+	const __m512i lane = _mm512_mullo_epi64(_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0), k);
+	for (size_t r = 0U; r < 4U; ++r)
+	{
+		y[r] = _mm512_add_epi64(_mm512_set1_epi64((long long)((ctr + (r << 3U)) * key)), lane);
+	}
+	const __m512i odd = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+	for (; count >= 32U; count -= 32U, out += 32U, ctr += 32U)
+	{
+		__m512i x[4U];
+		for (size_t r = 0U; r < 4U; ++r)
+		{
+			const __m512i z = _mm512_add_epi64(y[r], k);
+			x[r] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(y[r], y[r]), y[r]), 32);
+			x[r] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(x[r], x[r]), z), 32);
+			x[r] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(x[r], x[r]), y[r]), 32);
+			x[r] = _mm512_add_epi64(_mm512_mullo_epi64(x[r], x[r]), z);
+			y[r] = _mm512_add_epi64(y[r], step);
+		}
+		_mm512_storeu_si512(out, _mm512_permutex2var_epi32(x[0U], odd, x[1U]));
+		_mm512_storeu_si512(out + 16U, _mm512_permutex2var_epi32(x[2U], odd, x[3U]));
+	}
+	msws_squares32_scalar(key, ctr, out, count);
+}
+#endif
+
+/*
+ * Batch warm-up: runs the 13 rounds of msws_init() on structure-of-arrays
+ * contexts. Groups of lanes are kept in registers for all rounds, so that
+ * independent lanes hide the multiply latency. The count must be a
+ * multiple of 64.
+ */
+
+#define MSWS_INIT_BLOCK 256U
+
+inline static void msws_warmup_scalar(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const size_t count)
+{
+	for (size_t i = 0U; i < count; i += 4U)
+	{
+		uint64_t xi[4U] = { x[i], x[i + 1U], x[i + 2U], x[i + 3U] }, wi[4U] = { w[i], w[i + 1U], w[i + 2U], w[i + 3U] };
+		for (int r = 0; r < 13; ++r)
+		{
+			for (size_t j = 0U; j < 4U; ++j)
+			{
+				msws_round(xi + j, wi + j, s[i + j]);
+			}
+		}
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			x[i + j] = xi[j]; w[i + j] = wi[j];
+		}
+	}
+}
+
+#if defined(MSWS_X86)
+MSWS_TARGET("sse4.1") inline static void msws_warmup_sse41(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const size_t count)
+{
+	for (size_t i = 0U; i < count; i += 8U)
+	{
+		__m128i xi[4U], wi[4U], si[4U];
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			xi[j] = _mm_loadu_si128((const __m128i*)(x + i + (j << 1U)));
+			wi[j] = _mm_loadu_si128((const __m128i*)(w + i + (j << 1U)));
+			si[j] = _mm_loadu_si128((const __m128i*)(s + i + (j << 1U)));
+		}
+		for (int r = 0; r < 13; ++r)
+		{
+			for (size_t j = 0U; j < 4U; ++j)
+			{
+				wi[j] = _mm_add_epi64(wi[j], si[j]);
+				xi[j] = _mm_shuffle_epi32(_mm_add_epi64(msws_sse41_sqr(xi[j]), wi[j]), 0xB1);
+			}
+		}
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			_mm_storeu_si128((__m128i*)(x + i + (j << 1U)), xi[j]);
+			_mm_storeu_si128((__m128i*)(w + i + (j << 1U)), wi[j]);
+		}
+	}
+}
+
+MSWS_TARGET("avx2") inline static void msws_warmup_avx2(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const size_t count)
+{
+	for (size_t i = 0U; i < count; i += 16U)
+	{
+		__m256i xi[4U], wi[4U], si[4U];
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			xi[j] = _mm256_loadu_si256((const __m256i*)(x + i + (j << 2U)));
+			wi[j] = _mm256_loadu_si256((const __m256i*)(w + i + (j << 2U)));
+			si[j] = _mm256_loadu_si256((const __m256i*)(s + i + (j << 2U)));
+		}
+		for (int r = 0; r < 13; ++r)
+		{
+			for (size_t j = 0U; j < 4U; ++j)
+			{
+				wi[j] = _mm256_add_epi64(wi[j], si[j]);
+				xi[j] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(xi[j]), wi[j]), 0xB1);
+			}
+		}
+		for (size_t j = 0U; j < 4U; ++j)
+		{
+			_mm256_storeu_si256((__m256i*)(x + i + (j << 2U)), xi[j]);
+			_mm256_storeu_si256((__m256i*)(w + i + (j << 2U)), wi[j]);
+		}
+	}
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw") inline static void msws_warmup_avx512(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const size_t count)
+{
+	for (size_t i = 0U; i < count; i += 64U)
+	{
+		__m512i xi[8U], wi[8U], si[8U];
+		for (size_t j = 0U; j < 8U; ++j)
+		{
+			xi[j] = _mm512_loadu_si512(x + i + (j << 3U));
+			wi[j] = _mm512_loadu_si512(w + i + (j << 3U));
+			si[j] = _mm512_loadu_si512(s + i + (j << 3U));
+		}
+		for (int r = 0; r < 13; ++r)
+		{
+			for (size_t j = 0U; j < 8U; ++j)
+			{
+				wi[j] = _mm512_add_epi64(wi[j], si[j]);
+				xi[j] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(xi[j], xi[j]), wi[j]), 32);
+			}
+		}
+		for (size_t j = 0U; j < 8U; ++j)
+		{
+			_mm512_storeu_si512(x + i + (j << 3U), xi[j]);
+			_mm512_storeu_si512(w + i + (j << 3U), wi[j]);
+		}
+	}
+}
+#endif
+
+/*
+ * Generator bank: one MSWS state per element, stored as separate x[], w[]
+ * and s[] arrays. The step kernels advance every element by one round (or
+ * only those selected by a bit mask) and write element i's value to out[i].
+ */
+
+inline static void msws_step_scalar(uint64_t *const x, uint64_t *const w, const uint64_t *const s, uint32_t *const out, const size_t count)
+{
+	for (size_t i = 0U; i < count; ++i)
+	{
+		out[i] = msws_round(x + i, w + i, s[i]);
+	}
+}
+
+inline static void msws_step_masked_tail(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const uint64_t *const mask, uint32_t *const out, size_t i, const size_t count)
+{
+	for (; i < count; ++i)
+	{
+		if ((mask[i >> 6U] >> (i & 63U)) & 1U)
+		{
+			out[i] = msws_round(x + i, w + i, s[i]);
+		}
+	}
+}
+
+inline static void msws_step_masked_scalar(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const uint64_t *const mask, uint32_t *const out, const size_t count)
+{
+	msws_step_masked_tail(x, w, s, mask, out, 0U, count);
+}
+
+#if defined(MSWS_X86)
+MSWS_TARGET("sse4.1") inline static void msws_step_sse41(uint64_t *const x, uint64_t *const w, const uint64_t *const s, uint32_t *const out, const size_t count)
+{
+	size_t i = 0U;
+	for (; i + 4U <= count; i += 4U)
+	{
+		__m128i xi[2U];
+		for (size_t j = 0U; j < 2U; ++j)
+		{
+			const __m128i wi = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(w + i + (j << 1U))), _mm_loadu_si128((const __m128i*)(s + i + (j << 1U))));
+			xi[j] = _mm_shuffle_epi32(_mm_add_epi64(msws_sse41_sqr(_mm_loadu_si128((const __m128i*)(x + i + (j << 1U)))), wi), 0xB1);
+			_mm_storeu_si128((__m128i*)(w + i + (j << 1U)), wi);
+			_mm_storeu_si128((__m128i*)(x + i + (j << 1U)), xi[j]);
+		}
+		_mm_storeu_si128((__m128i*)(out + i), _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(xi[0U]), _mm_castsi128_ps(xi[1U]), 0x88)));
+	}
+	msws_step_scalar(x + i, w + i, s + i, out + i, count - i);
+}
+
+MSWS_TARGET("avx2") inline static void msws_step_avx2(uint64_t *const x, uint64_t *const w, const uint64_t *const s, uint32_t *const out, const size_t count)
+{
+	size_t i = 0U;
+	for (; i + 8U <= count; i += 8U)
+	{
+		__m256i xi[2U];
+		for (size_t j = 0U; j < 2U; ++j)
+		{
+			const __m256i wi = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(w + i + (j << 2U))), _mm256_loadu_si256((const __m256i*)(s + i + (j << 2U))));
+			xi[j] = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(_mm256_loadu_si256((const __m256i*)(x + i + (j << 2U)))), wi), 0xB1);
+			_mm256_storeu_si256((__m256i*)(w + i + (j << 2U)), wi);
+			_mm256_storeu_si256((__m256i*)(x + i + (j << 2U)), xi[j]);
+		}
+		const __m256 lo = _mm256_shuffle_ps(_mm256_castsi256_ps(xi[0U]), _mm256_castsi256_ps(xi[1U]), 0x88);
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(_mm256_castps_si256(lo), 0xD8));
+	}
+	msws_step_scalar(x + i, w + i, s + i, out + i, count - i);
+}
+
+MSWS_TARGET("avx2") inline static void msws_step_masked_avx2(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const uint64_t *const mask, uint32_t *const out, const size_t count)
+{
+	const __m256i bit64 = _mm256_set_epi64x(8, 4, 2, 1);
+	const __m128i bit32 = _mm_set_epi32(8, 4, 2, 1);
+	size_t i = 0U;
+	for (; i + 4U <= count; i += 4U)
+	{
+		const int bits = (int)((mask[i >> 6U] >> (i & 63U)) & 0xFU);
+		if (!bits)
+		{
+			continue;
+		}
+		const __m256i sel = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), bit64), bit64);
+		const __m256i xo = _mm256_loadu_si256((const __m256i*)(x + i)), wo = _mm256_loadu_si256((const __m256i*)(w + i));
+		const __m256i wi = _mm256_add_epi64(wo, _mm256_loadu_si256((const __m256i*)(s + i)));
+		const __m256i xi = _mm256_shuffle_epi32(_mm256_add_epi64(msws_avx2_sqr(xo), wi), 0xB1);
+		_mm256_storeu_si256((__m256i*)(w + i), _mm256_blendv_epi8(wo, wi, sel));
+		_mm256_storeu_si256((__m256i*)(x + i), _mm256_blendv_epi8(xo, xi, sel));
+		const __m128i lo = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(xi, _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0)));
+		_mm_maskstore_epi32((int*)(out + i), _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(bits), bit32), bit32), lo);
+	}
+	msws_step_masked_tail(x, w, s, mask, out, i, count);
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw") inline static void msws_step_avx512(uint64_t *const x, uint64_t *const w, const uint64_t *const s, uint32_t *const out, const size_t count)
+{
+	const __m512i even = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+	size_t i = 0U;
+	for (; i + 16U <= count; i += 16U)
+	{
+		__m512i xi[2U];
+		for (size_t j = 0U; j < 2U; ++j)
+		{
+			const __m512i wi = _mm512_add_epi64(_mm512_loadu_si512(w + i + (j << 3U)), _mm512_loadu_si512(s + i + (j << 3U)));
+			xi[j] = _mm512_loadu_si512(x + i + (j << 3U));
+			xi[j] = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(xi[j], xi[j]), wi), 32);
+			_mm512_storeu_si512(w + i + (j << 3U), wi);
+			_mm512_storeu_si512(x + i + (j << 3U), xi[j]);
+		}
+		_mm512_storeu_si512(out + i, _mm512_permutex2var_epi32(xi[0U], even, xi[1U]));
+	}
+	msws_step_scalar(x + i, w + i, s + i, out + i, count - i);
+}
+
+MSWS_TARGET("avx512f,avx512dq,avx512bw") inline static void msws_step_masked_avx512(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const uint64_t *const mask, uint32_t *const out, const size_t count)
+{
+	size_t i = 0U;
+	for (; i + 8U <= count; i += 8U)
+	{
+		const __mmask8 sel = (__mmask8)(mask[i >> 6U] >> (i & 63U));
+		if (!sel)
+		{
+			continue;
+		}
+		const __m512i xi = _mm512_maskz_loadu_epi64(sel, x + i);
+		const __m512i wi = _mm512_add_epi64(_mm512_maskz_loadu_epi64(sel, w + i), _mm512_maskz_loadu_epi64(sel, s + i));
+		const __m512i xn = _mm512_ror_epi64(_mm512_add_epi64(_mm512_mullo_epi64(xi, xi), wi), 32);
+		_mm512_mask_storeu_epi64(w + i, sel, wi);
+		_mm512_mask_storeu_epi64(x + i, sel, xn);
+		_mm512_mask_cvtepi64_storeu_epi32(out + i, sel, xn);
+	}
+	msws_step_masked_tail(x, w, s, mask, out, i, count);
+}
+#endif
+
+#if defined(MSWS_X86)
+inline static void msws_cpuid(const uint32_t leaf, uint32_t *const regs)
+{
+#if defined(_MSC_VER)
+	int tmp[4];
+	__cpuidex(tmp, (int)leaf, 0);
+	for (size_t i = 0U; i < 4U; ++i)
+	{
+		regs[i] = (uint32_t)tmp[i];
+	}
+#else
+	__cpuid_count(leaf, 0U, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+inline static uint64_t msws_xgetbv(void)
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t lo, hi;
+	__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return (((uint64_t)hi) << 32U) | lo;
+#endif
+}
+#endif
+
+typedef enum
+{
+	MSWS_KERNEL_SCALAR,
+	MSWS_KERNEL_SSE41,
+	MSWS_KERNEL_AVX2,
+	MSWS_KERNEL_AVX512,
+	MSWS_KERNEL_MAX
+}
+msws_kernel_id;
+
+typedef struct
+{
+	const char *name;
+	void (*x32_bytes)(msws_x32_t *const ctx, uint8_t *buffer, size_t len);
+	size_t (*bounded)(uint32_t *const data, const size_t len, const uint32_t max, const uint32_t threshold);
+	void (*squares32)(const uint64_t key, uint64_t ctr, uint32_t *out, size_t count);
+	void (*warmup)(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const size_t count);
+	void (*step)(uint64_t *const x, uint64_t *const w, const uint64_t *const s, uint32_t *const out, const size_t count);
+	void (*step_masked)(uint64_t *const x, uint64_t *const w, const uint64_t *const s, const uint64_t *const mask, uint32_t *const out, const size_t count);
+}
+msws_kernel_t;
+
+#if defined(MSWS_X86)
+#define MSWS_KERNEL_X86(X) X
+#else
+#define MSWS_KERNEL_X86(X) NULL
+#endif
+
+inline static const msws_kernel_t *msws_kernel_table(void)
+{
+	static const msws_kernel_t KERNELS[MSWS_KERNEL_MAX] =
+	{
+		{ "scalar", msws_x32_bytes_scalar, msws_bounded_scalar, msws_squares32_scalar, msws_warmup_scalar, msws_step_scalar, msws_step_masked_scalar },
+		{ "sse4.1", MSWS_KERNEL_X86(msws_x32_bytes_sse41),  MSWS_KERNEL_X86(msws_bounded_sse41),  msws_squares32_scalar,                 MSWS_KERNEL_X86(msws_warmup_sse41),  MSWS_KERNEL_X86(msws_step_sse41),  msws_step_masked_scalar },
+		{ "avx2",   MSWS_KERNEL_X86(msws_x32_bytes_avx2),   MSWS_KERNEL_X86(msws_bounded_avx2),   MSWS_KERNEL_X86(msws_squares32_avx2),   MSWS_KERNEL_X86(msws_warmup_avx2),   MSWS_KERNEL_X86(msws_step_avx2),   MSWS_KERNEL_X86(msws_step_masked_avx2) },
+		{ "avx512", MSWS_KERNEL_X86(msws_x32_bytes_avx512), MSWS_KERNEL_X86(msws_bounded_avx512), MSWS_KERNEL_X86(msws_squares32_avx512), MSWS_KERNEL_X86(msws_warmup_avx512), MSWS_KERNEL_X86(msws_step_avx512), MSWS_KERNEL_X86(msws_step_masked_avx512) }
+	};
+	return KERNELS;
+}
+
+inline static msws_kernel_id msws_kernel_detect(void)
+{
+	msws_kernel_id best = MSWS_KERNEL_SCALAR;
+#if defined(MSWS_X86)
+	uint32_t regs[4U];
+	msws_cpuid(0U, regs);
+	const uint32_t max_leaf = regs[0U];
+	msws_cpuid(1U, regs);
+	if (regs[2U] & (1U << 19U))
+	{
+		best = MSWS_KERNEL_SSE41;
+	}
+	if ((max_leaf >= 7U) && (regs[2U] & (1U << 27U)) && (regs[2U] & (1U << 28U)))
+	{
+		const uint64_t xcr0 = msws_xgetbv();
+		msws_cpuid(7U, regs);
+		if (((xcr0 & 0x06U) == 0x06U) && (regs[1U] & (1U << 5U)))
+		{
+			best = MSWS_KERNEL_AVX2;
+			if (((xcr0 & 0xE6U) == 0xE6U) && ((regs[1U] & 0x40030000U) == 0x40030000U))
+			{
+				best = MSWS_KERNEL_AVX512;
+			}
+		}
+	}
+#endif
+	return best;
+}
+
+inline static const msws_kernel_t *msws_kernel_lookup(const char *const name)
+{
+	const msws_kernel_id best = msws_kernel_detect();
+	if (!strcmp(name, "auto"))
+	{
+		return msws_kernel_table() + best;
+	}
+	for (int i = MSWS_KERNEL_SCALAR; i <= (int)best; ++i)
+	{
+		if (!strcmp(name, msws_kernel_table()[i].name))
+		{
+			return msws_kernel_table() + i;
+		}
+	}
+	return NULL;
+}
+
+inline static const msws_kernel_t *msws_kernel_default(void)
+{
+	const char *const name = getenv("MSWS_KERNEL");
+	const msws_kernel_t *const kernel = name ? msws_kernel_lookup(name) : NULL;
+	return kernel ? kernel : (msws_kernel_table() + msws_kernel_detect());
+}
+
+#if defined(MSWS_CXX11)
+
+inline std::atomic<const msws_kernel_t*> *msws_kernel_slot(void)
+{
+	static std::atomic<const msws_kernel_t*> kernel(NULL); /*external linkage, shared by all translation units*/
+	return &kernel;
+}
+
+inline static const msws_kernel_t *msws_kernel(void)
+{
+	const msws_kernel_t *kernel = msws_kernel_slot()->load(std::memory_order_acquire);
+	if (!kernel)
+	{
+		const msws_kernel_t *expected = NULL;
+		kernel = msws_kernel_default();
+		if (!msws_kernel_slot()->compare_exchange_strong(expected, kernel, std::memory_order_acq_rel))
+		{
+			kernel = expected;
+		}
+	}
+	return kernel;
+}
+
+inline static int msws_kernel_select(const char *const name)
+{
+	const msws_kernel_t *const kernel = msws_kernel_lookup(name);
+	if (kernel)
+	{
+		msws_kernel_slot()->store(kernel, std::memory_order_release);
+		return 1;
+	}
+	return 0;
+}
+
+#else
+
+inline static const msws_kernel_t **msws_kernel_slot(void)
+{
+#ifdef __cplusplus
+	static const msws_kernel_t *kernel = msws_kernel_default();
+#else
+	static const msws_kernel_t *kernel = NULL;
+	if (!kernel)
+	{
+		kernel = msws_kernel_default();
+	}
+#endif
+	return &kernel;
+}
+
+inline static const msws_kernel_t *msws_kernel(void)
+{
+	return *msws_kernel_slot();
+}
+
+inline static int msws_kernel_select(const char *const name)
+{
+	const msws_kernel_t *const kernel = msws_kernel_lookup(name);
+	if (kernel)
+	{
+		*msws_kernel_slot() = kernel;
+		return 1;
+	}
+	return 0;
+}
+
+#endif
+
+inline static void msws_squares32_array(const uint64_t key, const uint64_t ctr, uint32_t *const out, const size_t count)
+{
+	msws_kernel()->squares32(key, ctr, out, count);
+}
+
+inline static void msws_squares64_array(const uint64_t key, uint64_t ctr, uint64_t *out, size_t count)
+{
+	for (; count >= 2U; count -= 2U, out += 2U, ctr += 2U)
+	{
+		out[0U] = msws_squares64(ctr, key);
+		out[1U] = msws_squares64(ctr + 1U, key);
+	}
+	if (count)
+	{
+		*out = msws_squares64(ctr, key);
+	}
+}
+
+#define MSWS_BOUNDED_BLOCK 1024U
+
+inline static uint32_t msws_bounded_threshold(const uint32_t max)
+{
+	return max ? ((0U - max) % max) : 0U;
+}
+
+inline static void msws_uint32_bounded_array(msws_t ctx, uint32_t *out, size_t count, const uint32_t max)
+{
+	const uint32_t threshold = msws_bounded_threshold(max);
+	while (count)
+	{
+		const size_t len = (count < MSWS_BOUNDED_BLOCK) ? count : MSWS_BOUNDED_BLOCK;
+		msws_uint32_array(ctx, out, len);
+		const size_t accepted = msws_kernel()->bounded(out, len, max, threshold);
+		out += accepted; count -= accepted;
+	}
+}
+
+inline static uint32_t msws_x32_uint32(msws_x32_t *const ctx)
+{
+	if (ctx->pos >= MSWS_X32_LANES)
+	{
+		msws_x32_step(ctx, ctx->buff);
+		ctx->pos = 0U;
+	}
+	return ctx->buff[ctx->pos++];
+}
+
+inline static uint32_t msws_x32_uint32_bounded(msws_x32_t *const ctx, const uint32_t max)
+{
+	uint64_t m = ((uint64_t)msws_x32_uint32(ctx)) * max;
+	if (((uint32_t)m) < max)
+	{
+		const uint32_t threshold = (0U - max) % max;
+		while (((uint32_t)m) < threshold)
+		{
+			m = ((uint64_t)msws_x32_uint32(ctx)) * max;
+		}
+	}
+	return (uint32_t)(m >> 32U);
+}
+
+inline static uint64_t msws_x32_uint64(msws_x32_t *const ctx)
+{
+	const uint64_t hi = msws_x32_uint32(ctx);
+	return (hi << 32U) | msws_x32_uint32(ctx);
+}
+
+inline static void msws_x32_bytes(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	if (ctx->pos < MSWS_X32_LANES)
+	{
+		const size_t avail = (MSWS_X32_LANES - ctx->pos) << 2U;
+		const size_t count = (len < avail) ? len : avail;
+		memcpy(buffer, ctx->buff + ctx->pos, count);
+		ctx->pos += (count + 3U) >> 2U;
+		buffer += count; len -= count;
+	}
+	if (len)
+	{
+		msws_kernel()->x32_bytes(ctx, buffer, len);
+	}
+}
+
+inline static void msws_x32_bytes_nt(msws_x32_t *const ctx, uint8_t *buffer, size_t len)
+{
+	uint8_t stage[MSWS_NT_CHUNK];
+	while (len)
+	{
+		const size_t count = (len < MSWS_NT_CHUNK) ? len : MSWS_NT_CHUNK;
+		msws_x32_bytes(ctx, stage, count);
+		msws_store_nt(buffer, stage, count);
+		buffer += count; len -= count;
+	}
+	msws_store_nt_fence();
+}
+
+inline static void msws_x32_uint32_array(msws_x32_t *const ctx, uint32_t *const out, const size_t count)
+{
+	msws_x32_bytes(ctx, (uint8_t*)out, count * sizeof(uint32_t));
+}
+
+inline static void msws_x32_uint64_array(msws_x32_t *const ctx, uint64_t *const out, const size_t count)
+{
+	msws_x32_bytes(ctx, (uint8_t*)out, count * sizeof(uint64_t));
+	for (size_t i = 0U; i < count; ++i)
+	{
+		uint32_t words[2U];
+		memcpy(words, out + i, sizeof(words));
+		out[i] = (((uint64_t)words[0U]) << 32U) | words[1U];
+	}
+}
+
+inline static void msws_x32_uint32_bounded_array(msws_x32_t *const ctx, uint32_t *out, size_t count, const uint32_t max)
+{
+	const uint32_t threshold = msws_bounded_threshold(max);
+	while (count)
+	{
+		const size_t len = (count < MSWS_BOUNDED_BLOCK) ? count : MSWS_BOUNDED_BLOCK;
+		msws_x32_bytes(ctx, (uint8_t*)out, len * sizeof(uint32_t));
+		const size_t accepted = msws_kernel()->bounded(out, len, max, threshold);
+		out += accepted; count -= accepted;
+	}
+}
+
+inline static void msws_init_lanes(msws_t *const ctx, uint64_t *const s, const size_t count)
+{
+	uint64_t x[MSWS_INIT_BLOCK], w[MSWS_INIT_BLOCK];
+	const size_t padded = (count + 63U) & ~((size_t)63U);
+	for (size_t i = 0U; i < padded; ++i)
+	{
+		x[i] = UINT64_C(0); w[i] = UINT64_C(0);
+		if (i >= count)
+		{
+			s[i] = s[0U];
+		}
+	}
+	msws_kernel()->warmup(x, w, s, padded);
+	for (size_t i = 0U; i < count; ++i)
+	{
+		ctx[i][0] = x[i]; ctx[i][1] = w[i]; ctx[i][2] = s[i];
+	}
+}
+
+inline static void msws_init_array(msws_t *ctx, const uint32_t *seeds, size_t count)
+{
+	uint64_t s[MSWS_INIT_BLOCK];
+	while (count)
+	{
+		const size_t len = (count < MSWS_INIT_BLOCK) ? count : MSWS_INIT_BLOCK;
+		for (size_t i = 0U; i < len; ++i)
+		{
+			s[i] = (((uint64_t)seeds[i]) << 1U) + 0xB5AD4ECEDA1CE2A9;
+		}
+		msws_init_lanes(ctx, s, len);
+		ctx += len; seeds += len; count -= len;
+	}
+}
+
+inline static void msws_init_stream_array(msws_t *ctx, const uint64_t seed, const uint64_t *streams, size_t count)
+{
+	const uint64_t key = msws_key_next(MSWS_SQUARES_KEY, seed);
+	uint64_t s[MSWS_INIT_BLOCK];
+	while (count)
+	{
+		const size_t len = (count < MSWS_INIT_BLOCK) ? count : MSWS_INIT_BLOCK;
+		for (size_t i = 0U; i < len; ++i)
+		{
+			s[i] = msws_key_next(key, streams[i]);
+		}
+		msws_init_lanes(ctx, s, len);
+		ctx += len; streams += len; count -= len;
+	}
+}
+
+typedef struct
+{
+	uint64_t *x, *w, *s;
+	size_t count;
+	void *mem;
+}
+msws_array_t;
+
+inline static int msws_array_init(msws_array_t *const ctx, const uint64_t seed, const size_t count)
+{
+	const size_t capacity = (count + 63U) & ~((size_t)63U);
+	memset(ctx, 0, sizeof(msws_array_t));
+	if (!(ctx->mem = malloc((3U * capacity * sizeof(uint64_t)) + 64U)))
+	{
+		return 0;
+	}
+	ctx->x = (uint64_t*)((((uintptr_t)ctx->mem) + 63U) & ~((uintptr_t)63U));
+	ctx->w = ctx->x + capacity; ctx->s = ctx->w + capacity;
+	ctx->count = count;
+	const uint64_t key = msws_key_next(MSWS_SQUARES_KEY, seed);
+	for (size_t i = 0U; i < capacity; ++i)
+	{
+		ctx->x[i] = UINT64_C(0); ctx->w[i] = UINT64_C(0);
+		ctx->s[i] = (i < count) ? msws_key_next(key, i) : ctx->s[0U];
+	}
+	if (capacity)
+	{
+		msws_kernel()->warmup(ctx->x, ctx->w, ctx->s, capacity);
+	}
+	return 1;
+}
+
+inline static void msws_array_free(msws_array_t *const ctx)
+{
+	free(ctx->mem);
+	memset(ctx, 0, sizeof(msws_array_t));
+}
+
+inline static uint32_t msws_array_uint32(msws_array_t *const ctx, const size_t index)
+{
+	return msws_round(ctx->x + index, ctx->w + index, ctx->s[index]);
+}
+
+inline static void msws_array_next_all(msws_array_t *const ctx, uint32_t *const out)
+{
+	msws_kernel()->step(ctx->x, ctx->w, ctx->s, out, ctx->count);
+}
+
+inline static void msws_array_next_masked(msws_array_t *const ctx, const uint64_t *const mask, uint32_t *const out)
+{
+	msws_kernel()->step_masked(ctx->x, ctx->w, ctx->s, mask, out, ctx->count);
+}
+
+inline static void msws_array_next_indexed(msws_array_t *const ctx, const uint32_t *const index, uint32_t *const out, const size_t count)
+{
+	for (size_t i = 0U; i < count; ++i)
+	{
+		out[i] = msws_round(ctx->x + index[i], ctx->w + index[i], ctx->s[index[i]]);
+	}
+}
+
+inline static void msws_x32_init(msws_x32_t *const ctx, const uint32_t seed)
+{
+	for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+	{
+		ctx->x[i] = UINT64_C(0); ctx->w[i] = UINT64_C(0);
+		ctx->s[i] = (((uint64_t)seed) << 1U) + 0xB5AD4ECEDA1CE2A9 + (((uint64_t)i) * UINT64_C(0x3C6EF372FE94F82A));
+	}
+	for (int i = 0; i < 13; ++i)
+	{
+		msws_x32_step(ctx, ctx->buff);
+	}
+	ctx->pos = MSWS_X32_LANES;
+}
+
+inline static void msws_x32_init_stream(msws_x32_t *const ctx, const uint64_t seed, const uint64_t stream)
+{
+	const uint64_t key = msws_key_next(MSWS_SQUARES_KEY, seed);
+	for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+	{
+		ctx->x[i] = UINT64_C(0); ctx->w[i] = UINT64_C(0);
+		ctx->s[i] = msws_key_next(key, (stream * MSWS_X32_LANES) + i);
+	}
+	for (int i = 0; i < 13; ++i)
+	{
+		msws_x32_step(ctx, ctx->buff);
+	}
+	ctx->pos = MSWS_X32_LANES;
+}
+
+#ifdef __cplusplus
+} //impl
+
+class rng
+{
+public:
+	/*Seeds below 2^32 match the former 32-Bit constructor; pass negative values as (uint32_t) to keep their old sequence*/
+	inline rng(const uint64_t seed)
+	{
+		impl::msws_init_seed64(m_ctx, seed);
+	}
+
+	inline rng(const uint64_t seed, const uint64_t stream)
+	{
+		impl::msws_init_stream(m_ctx, seed, stream);
+	}
+
+	inline uint32_t uint32(void)
+	{
+		return impl::msws_uint32(m_ctx);
+	}
+
+	inline uint32_t uint32(const uint32_t max)
+	{
+		return impl::msws_uint32_bounded(m_ctx, max);
+	}
+
+	inline uint32_t uint32_legacy(const uint32_t max)
+	{
+		return impl::msws_uint32_max(m_ctx, max);
+	}
+
+	inline uint64_t uint64(void)
+	{
+		return impl::msws_uint64(m_ctx);
+	}
+
+	inline void bytes(uint8_t *const buffer, const size_t len)
+	{
+		return impl::msws_bytes(m_ctx, buffer, len);
+	}
+
+	inline void bytes_nt(uint8_t *const buffer, const size_t len)
+	{
+		return impl::msws_bytes_nt(m_ctx, buffer, len);
+	}
+
+	inline void uint32_array(uint32_t *const out, const size_t count)
+	{
+		return impl::msws_uint32_array(m_ctx, out, count);
+	}
+
+	inline void uint32_array(uint32_t *const out, const size_t count, const uint32_t max)
+	{
+		return impl::msws_uint32_bounded_array(m_ctx, out, count, max);
+	}
+
+	inline void uint64_array(uint64_t *const out, const size_t count)
+	{
+		return impl::msws_uint64_array(m_ctx, out, count);
+	}
+
+	static inline void init(rng *const out, const uint32_t *const seeds, const size_t count)
+	{
+		impl::msws_t ctx[MSWS_INIT_BLOCK];
+		for (size_t i = 0U; i < count; i += MSWS_INIT_BLOCK)
+		{
+			const size_t len = ((count - i) < MSWS_INIT_BLOCK) ? (count - i) : MSWS_INIT_BLOCK;
+			impl::msws_init_array(ctx, seeds + i, len);
+			assign(out + i, ctx, len);
+		}
+	}
+
+	static inline void init(rng *const out, const uint64_t seed, const uint64_t *const streams, const size_t count)
+	{
+		impl::msws_t ctx[MSWS_INIT_BLOCK];
+		for (size_t i = 0U; i < count; i += MSWS_INIT_BLOCK)
+		{
+			const size_t len = ((count - i) < MSWS_INIT_BLOCK) ? (count - i) : MSWS_INIT_BLOCK;
+			impl::msws_init_stream_array(ctx, seed, streams + i, len);
+			assign(out + i, ctx, len);
+		}
+	}
+
+private:
+	static inline void assign(rng *const out, const impl::msws_t *const ctx, const size_t count)
+	{
+		for (size_t i = 0U; i < count; ++i)
+		{
+			memcpy(out[i].m_ctx, ctx[i], sizeof(impl::msws_t));
+		}
+	}
+
+	impl::msws_t m_ctx;
+};
+
+class rng64
+{
+public:
+	inline rng64(const uint32_t seed)
+	{
+		impl::msws64_init(m_ctx, seed);
+	}
+
+	inline uint32_t uint32(void)
+	{
+		return (uint32_t)(impl::msws64_uint64(m_ctx) >> 32U);
+	}
+
+	inline uint64_t uint64(void)
+	{
+		return impl::msws64_uint64(m_ctx);
+	}
+
+	inline uint64_t uint64(const uint64_t max)
+	{
+		return impl::msws64_uint64_bounded(m_ctx, max);
+	}
+
+	inline void bytes(uint8_t *const buffer, const size_t len)
+	{
+		return impl::msws64_bytes(m_ctx, buffer, len);
+	}
+
+	inline void uint64_array(uint64_t *const out, const size_t count)
+	{
+		return impl::msws64_uint64_array(m_ctx, out, count);
+	}
+
+private:
+	impl::msws64_t m_ctx;
+};
+
+inline const char *kernel(void)
+{
+	return impl::msws_kernel()->name;
+}
+
+inline bool set_kernel(const char *const name)
+{
+	return impl::msws_kernel_select(name) != 0;
+}
+
+class squares
+{
+public:
+	inline squares(const uint64_t key = MSWS_SQUARES_KEY) : m_key(key)
+	{
+	}
+
+	inline uint32_t uint32(const uint64_t ctr) const
+	{
+		return impl::msws_squares32(ctr, m_key);
+	}
+
+	inline uint64_t uint64(const uint64_t ctr) const
+	{
+		return impl::msws_squares64(ctr, m_key);
+	}
+
+	inline void generate(const uint64_t ctr, uint32_t *const out, const size_t count) const
+	{
+		return impl::msws_squares32_array(m_key, ctr, out, count);
+	}
+
+	inline void generate(const uint64_t ctr, uint64_t *const out, const size_t count) const
+	{
+		return impl::msws_squares64_array(m_key, ctr, out, count);
+	}
+
+	static inline void generate(const uint64_t key, const uint64_t ctr, uint32_t *const out, const size_t count)
+	{
+		return impl::msws_squares32_array(key, ctr, out, count);
+	}
+
+	static inline void generate(const uint64_t key, const uint64_t ctr, uint64_t *const out, const size_t count)
+	{
+		return impl::msws_squares64_array(key, ctr, out, count);
+	}
+
+	inline uint64_t key(void) const
+	{
+		return m_key;
+	}
+
+private:
+	const uint64_t m_key;
+};
+
+inline uint64_t key(const uint64_t seed, const uint64_t stream)
+{
+	return impl::msws_key(seed, stream);
+}
+
+inline void keys(const uint64_t seed, uint64_t *const out, const size_t count, const uint64_t first = 0U)
+{
+	return impl::msws_keys(seed, first, out, count);
+}
+
+class rng_x32
+{
+public:
+	inline rng_x32(const uint32_t seed)
+	{
+		impl::msws_x32_init(&m_ctx, seed);
+	}
+
+	inline uint32_t uint32(void)
+	{
+		return impl::msws_x32_uint32(&m_ctx);
+	}
+
+	inline uint32_t uint32(const uint32_t max)
+	{
+		return impl::msws_x32_uint32_bounded(&m_ctx, max);
+	}
+
+	inline uint64_t uint64(void)
+	{
+		return impl::msws_x32_uint64(&m_ctx);
+	}
+
+	inline void bytes(uint8_t *const buffer, const size_t len)
+	{
+		return impl::msws_x32_bytes(&m_ctx, buffer, len);
+	}
+
+	inline void bytes_nt(uint8_t *const buffer, const size_t len)
+	{
+		return impl::msws_x32_bytes_nt(&m_ctx, buffer, len);
+	}
+
+	inline void uint32_array(uint32_t *const out, const size_t count)
+	{
+		return impl::msws_x32_uint32_array(&m_ctx, out, count);
+	}
+
+	inline void uint32_array(uint32_t *const out, const size_t count, const uint32_t max)
+	{
+		return impl::msws_x32_uint32_bounded_array(&m_ctx, out, count, max);
+	}
+
+	inline void uint64_array(uint64_t *const out, const size_t count)
+	{
+		return impl::msws_x32_uint64_array(&m_ctx, out, count);
+	}
+
+private:
+	impl::msws_x32_t m_ctx;
+};
+
+#if defined(MSWS_CXX11)
+class engine
+{
+public:
+	typedef uint32_t result_type;
+
+	static const uint32_t default_seed = 0U;
+
+	static constexpr result_type min(void)
+	{
+		return 0U;
+	}
+
+	static constexpr result_type max(void)
+	{
+		return UINT32_MAX;
+	}
+
+	inline explicit engine(const uint32_t value = default_seed)
+	{
+		seed(value);
+	}
+
+	inline void seed(const uint32_t value = default_seed)
+	{
+		impl::msws_x32_init(&m_ctx, value);
+		refill();
+	}
+
+	inline result_type operator()(void)
+	{
+		if (m_pos >= BLOCK)
+		{
+			refill();
+		}
+		return m_buff[m_pos++];
+	}
+
+	inline void discard(unsigned long long count)
+	{
+		while (count > (BLOCK - m_pos))
+		{
+			count -= (BLOCK - m_pos);
+			refill();
+		}
+		m_pos += (size_t)count;
+	}
+
+	friend inline bool operator==(const engine &lhs, const engine &rhs)
+	{
+		return (lhs.m_pos == rhs.m_pos) && (!memcmp(lhs.m_base, rhs.m_base, sizeof(lhs.m_base))) && (!memcmp(lhs.m_ctx.s, rhs.m_ctx.s, sizeof(lhs.m_ctx.s)));
+	}
+
+	friend inline bool operator!=(const engine &lhs, const engine &rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template<class C, class T>
+	friend std::basic_ostream<C, T> &operator<<(std::basic_ostream<C, T> &out, const engine &rng)
+	{
+		typedef std::basic_ostream<C, T> stream_t;
+		const typename stream_t::fmtflags flags = out.flags(stream_t::dec | stream_t::left);
+		const C fill = out.fill(out.widen(' '));
+		for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+		{
+			out << rng.m_base[0U][i] << out.widen(' ') << rng.m_base[1U][i] << out.widen(' ') << rng.m_ctx.s[i] << out.widen(' ');
+		}
+		out << rng.m_pos;
+		out.flags(flags);
+		out.fill(fill);
+		return out;
+	}
+
+	template<class C, class T>
+	friend std::basic_istream<C, T> &operator>>(std::basic_istream<C, T> &in, engine &rng)
+	{
+		uint64_t state[3U][MSWS_X32_LANES];
+		size_t pos;
+		typedef std::basic_istream<C, T> stream_t;
+		const typename stream_t::fmtflags flags = in.flags(stream_t::dec | stream_t::skipws);
+		for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+		{
+			in >> state[0U][i] >> state[1U][i] >> state[2U][i];
+		}
+		in >> pos;
+		in.flags(flags);
+		if (!in.fail())
+		{
+			for (size_t i = 0U; i < MSWS_X32_LANES; ++i)
+			{
+				rng.m_ctx.x[i] = state[0U][i]; rng.m_ctx.w[i] = state[1U][i]; rng.m_ctx.s[i] = state[2U][i];
+			}
+			rng.m_ctx.pos = MSWS_X32_LANES;
+			rng.refill();
+			rng.m_pos = (pos < BLOCK) ? pos : BLOCK;
+		}
+		return in;
+	}
+
+private:
+	static const size_t BLOCK = 256U;
+
+	inline void refill(void)
+	{
+		memcpy(m_base[0U], m_ctx.x, sizeof(m_ctx.x));
+		memcpy(m_base[1U], m_ctx.w, sizeof(m_ctx.w));
+		impl::msws_x32_uint32_array(&m_ctx, m_buff, BLOCK);
+		m_pos = 0U;
+	}
+
+	alignas(64) uint32_t m_buff[BLOCK];
+	size_t m_pos;
+	impl::msws_x32_t m_ctx;
+	uint64_t m_base[2U][MSWS_X32_LANES];
+};
+
+class async_rng
+{
+public:
+	inline explicit async_rng(const uint32_t seed)
+	:
+		m_head(0U), m_tail_shared(0U), m_waiting(false), m_stop(false),
+		m_tail(0U), m_limit(0U), m_fallback((uint64_t)seed, UINT64_C(0)),
+		m_producer(seed)
+	{
+		m_thread = std::thread(&async_rng::produce, this);
+	}
+
+	inline ~async_rng(void)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop.store(true);
+		}
+		m_cond.notify_one();
+		m_thread.join();
+	}
+
+	async_rng(const async_rng&) = delete;
+	async_rng &operator=(const async_rng&) = delete;
+
+	inline uint32_t uint32(void)
+	{
+		if ((m_tail == m_limit) && (!acquire()))
+		{
+			return m_fallback.uint32();
+		}
+		return m_ring[(m_tail++) & (CAPACITY - 1U)];
+	}
+
+	inline uint64_t uint64(void)
+	{
+		const uint64_t hi = uint32();
+		return (hi << 32U) | uint32();
+	}
+
+	inline void uint32_array(uint32_t *out, size_t count)
+	{
+		while (count)
+		{
+			if ((m_tail == m_limit) && (!acquire()))
+			{
+				return m_fallback.uint32_array(out, count);
+			}
+			const size_t len = ((m_limit - m_tail) < count) ? (size_t)(m_limit - m_tail) : count;
+			memcpy(out, m_ring + (m_tail & (CAPACITY - 1U)), len * sizeof(uint32_t));
+			m_tail += len; out += len; count -= len;
+		}
+	}
+
+private:
+	static const size_t CAPACITY = 16384U, CHUNK = 1024U;
+
+	inline bool acquire(void)
+	{
+		m_tail_shared.store(m_tail);
+		if (m_waiting.load())
+		{
+			std::lock_guard<std::mutex> lock(m_mutex); /*producer sleeps on a full ring, wake it*/
+			m_cond.notify_one();
+		}
+		const uint64_t head = m_head.load(std::memory_order_acquire);
+		const uint64_t next = (m_tail & ~((uint64_t)(CHUNK - 1U))) + CHUNK;
+		m_limit = (head < next) ? head : next;
+		return m_tail != m_limit;
+	}
+
+	inline void produce(void)
+	{
+		uint64_t head = 0U;
+		const auto writable = [&](void) { return (head - m_tail_shared.load()) <= (CAPACITY - CHUNK); };
+		while (!m_stop.load(std::memory_order_relaxed))
+		{
+			if (!writable())
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_waiting.store(true);
+				m_cond.wait(lock, [&] { return m_stop.load() || writable(); });
+				m_waiting.store(false, std::memory_order_relaxed);
+				continue;
+			}
+			m_producer.uint32_array(m_ring + (head & (CAPACITY - 1U)), CHUNK);
+			m_head.store(head += CHUNK, std::memory_order_release);
+		}
+	}
+
+	alignas(64) uint32_t m_ring[CAPACITY];
+	alignas(64) std::atomic<uint64_t> m_head;
+	alignas(64) std::atomic<uint64_t> m_tail_shared;
+	std::atomic<bool> m_waiting, m_stop;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	alignas(64) uint64_t m_tail, m_limit;
+	rng m_fallback;
+	alignas(64) rng_x32 m_producer;
+	std::thread m_thread;
+};
+
+inline std::atomic<uint64_t> *thread_rng_globals(void)
+{
+	static std::atomic<uint64_t> globals[2U] = { { (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count() }, { UINT64_C(0) } };
+	return globals;
+}
+
+inline void thread_rng_seed(const uint64_t seed)
+{
+	std::atomic<uint64_t> *const globals = thread_rng_globals();
+	globals[0U].store(seed);
+	globals[1U].store(UINT64_C(0));
+}
+
+inline rng &thread_rng(void)
+{
+	struct alignas(64) slot
+	{
+		inline slot(void) : value(thread_rng_globals()[0U].load(), thread_rng_globals()[1U].fetch_add(1U))
+		{
+		}
+		rng value;
+	};
+	static thread_local slot instance;
+	return instance.value;
+}
+
+class shared_rng
+{
+public:
+	inline explicit shared_rng(const uint64_t seed)
+	:
+		m_key(impl::msws_key(seed, UINT64_C(0))), m_ctr(UINT64_C(0))
+	{
+	}
+
+	shared_rng(const shared_rng&) = delete;
+	shared_rng &operator=(const shared_rng&) = delete;
+
+	inline uint32_t uint32(void)
+	{
+		return impl::msws_squares32(m_ctr.fetch_add(1U, std::memory_order_relaxed), m_key);
+	}
+
+	inline uint64_t uint64(void)
+	{
+		return impl::msws_squares64(m_ctr.fetch_add(1U, std::memory_order_relaxed), m_key);
+	}
+
+	inline void uint32_array(uint32_t *const out, const size_t count)
+	{
+		impl::msws_squares32_array(m_key, m_ctr.fetch_add(count, std::memory_order_relaxed), out, count);
+	}
+
+	inline void uint64_array(uint64_t *const out, const size_t count)
+	{
+		impl::msws_squares64_array(m_key, m_ctr.fetch_add(count, std::memory_order_relaxed), out, count);
+	}
+
+	inline uint64_t key(void) const
+	{
+		return m_key;
+	}
+
+private:
+	const uint64_t m_key;
+	alignas(64) std::atomic<uint64_t> m_ctr;
+	uint8_t m_padding[64U - sizeof(std::atomic<uint64_t>)];
+};
+
+#define MSWS_PARALLEL_CHUNK (1U << 20U)
+
+inline void parallel_bytes(const uint64_t seed, uint8_t *const buffer, const size_t len, unsigned threads = 0U)
+{
+	const size_t chunks = (len + MSWS_PARALLEL_CHUNK - 1U) / MSWS_PARALLEL_CHUNK;
+	std::atomic<size_t> next(0U);
+	const auto worker = [&](void)
+	{
+		impl::msws_x32_t ctx;
+		for (size_t i; (i = next.fetch_add(1U, std::memory_order_relaxed)) < chunks;)
+		{
+			const size_t offset = i * MSWS_PARALLEL_CHUNK;
+			impl::msws_x32_init_stream(&ctx, seed, i);
+			impl::msws_x32_bytes(&ctx, buffer + offset, ((len - offset) < MSWS_PARALLEL_CHUNK) ? (len - offset) : MSWS_PARALLEL_CHUNK);
+		}
+	};
+	if (!threads)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	threads = (threads < chunks) ? threads : (unsigned)chunks;
+	if (threads <= 1U)
+	{
+		return worker();
+	}
+	std::thread *const pool = new std::thread[threads - 1U];
+	for (unsigned i = 0U; i < threads - 1U; ++i)
+	{
+		pool[i] = std::thread(worker);
+	}
+	worker();
+	for (unsigned i = 0U; i < threads - 1U; ++i)
+	{
+		pool[i].join();
+	}
+	delete[] pool;
+}
+#endif
+
+class rng_array
+{
+public:
+	inline rng_array(const uint64_t seed, const size_t count)
+	{
+		if (!impl::msws_array_init(&m_ctx, seed, count))
+		{
+			throw std::bad_alloc();
+		}
+	}
+
+	inline ~rng_array(void)
+	{
+		impl::msws_array_free(&m_ctx);
+	}
+
+	inline size_t size(void) const
+	{
+		return m_ctx.count;
+	}
+
+	inline uint32_t uint32(const size_t index)
+	{
+		return impl::msws_array_uint32(&m_ctx, index);
+	}
+
+	inline void next_all(uint32_t *const out)
+	{
+		return impl::msws_array_next_all(&m_ctx, out);
+	}
+
+	inline void next_masked(const uint64_t *const mask, uint32_t *const out)
+	{
+		return impl::msws_array_next_masked(&m_ctx, mask, out);
+	}
+
+	inline void next_indexed(const uint32_t *const index, uint32_t *const out, const size_t count)
+	{
+		return impl::msws_array_next_indexed(&m_ctx, index, out, count);
+	}
+
+private:
+	rng_array(const rng_array&);
+	rng_array &operator=(const rng_array&);
+
+	impl::msws_array_t m_ctx;
+};
+
+template<typename T>
+class bounded
+{
+public:
+	inline bounded(const T max)
+	:
+		m_max(max),
+		m_threshold(max ? ((T)(((T)0U) - max) % max) : ((T)0U))
+	{
+	}
+
+	template<class R>
+	inline T operator()(R &rng) const
+	{
+		T lo, hi = mul(next(rng, m_max), m_max, lo);
+		if (lo < m_max)
+		{
+			while (lo < m_threshold)
+			{
+				hi = mul(next(rng, m_max), m_max, lo);
+			}
+		}
+		return hi;
+	}
+
+	template<class R>
+	inline void fill(R &rng, T *out, size_t count) const
+	{
+		while (count)
+		{
+			const size_t len = (count < MSWS_BOUNDED_BLOCK) ? count : MSWS_BOUNDED_BLOCK;
+			array(rng, out, len);
+			const size_t accepted = compact(out, len);
+			out += accepted; count -= accepted;
+		}
+	}
+
+	inline T max(void) const
+	{
+		return m_max;
+	}
+
+private:
+	template<class R> static inline uint32_t next(R &rng, const uint32_t) { return rng.uint32(); }
+	template<class R> static inline uint64_t next(R &rng, const uint64_t) { return rng.uint64(); }
+
+	template<class R> static inline void array(R &rng, uint32_t *const out, const size_t count) { rng.uint32_array(out, count); }
+	template<class R> static inline void array(R &rng, uint64_t *const out, const size_t count) { rng.uint64_array(out, count); }
+
+	inline size_t compact(uint32_t *const data, const size_t len) const
+	{
+		return impl::msws_kernel()->bounded(data, len, m_max, m_threshold);
+	}
+
+	inline size_t compact(uint64_t *const data, const size_t len) const
+	{
+		size_t k = 0U;
+		for (size_t i = 0U; i < len; ++i)
+		{
+			uint64_t lo;
+			const uint64_t hi = mul(data[i], m_max, lo);
+			if (lo >= m_threshold)
+			{
+				data[k++] = hi;
+			}
+		}
+		return k;
+	}
+
+	static inline uint32_t mul(const uint32_t a, const uint32_t b, uint32_t &lo)
+	{
+		const uint64_t m = ((uint64_t)a) * b;
+		lo = (uint32_t)m;
+		return (uint32_t)(m >> 32U);
+	}
+
+	static inline uint64_t mul(const uint64_t a, const uint64_t b, uint64_t &lo)
+	{
+		uint64_t hi;
+		lo = impl::msws_mul128(a, b, &hi);
+		return hi;
+	}
+
+	T m_max, m_threshold;
 };
 
 } //msws
@@ -0,0 +1,139 @@
+/**************************************************************************\
+*                                                                          *
+*  Middle Square Weyl Sequence Random Number Generator                     *
+*                                                                          *
+*  Benchmark: fill throughput and cache pollution of the bulk generators   *
+*                                                                          *
+*  A working set is warmed up and then walked in random order (pointer     *
+*  chasing, so hardware prefetch cannot hide misses) after each large      *
+*  fill. Regular fills evict the working set from the caches, streaming    *
+*  (non-temporal) fills should leave it mostly intact. As a control, the   *
+*  walk is repeated after spinning (without memory traffic) for as long as *
+*  the fill took, which shows the eviction caused by everything else.      *
+*                                                                          *
+*  Copyright (c) 2017 LoRd_MuldeR <mulder2@gmx.de>                         *
+*                                                                          *
+*  This code can be used under the terms of the GNU General Public License *
+*  as published by the Free Software Foundation, either version 3 of the   *
+*  License, or any later version. See the GPL license at URL               *
+*  http://www.gnu.org/licenses                                             *
+*                                                                          *
+\**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "msws.h"
+
+static const size_t LINE_SIZE = 64U;
+
+typedef std::chrono::steady_clock clk;
+
+static double elapsed(const clk::time_point &start)
+{
+	return std::chrono::duration<double>(clk::now() - start).count();
+}
+
+static void mkchain(std::vector<size_t> &chain)
+{
+	const size_t stride = LINE_SIZE / sizeof(size_t), lines = chain.size() / stride;
+	std::vector<size_t> order(lines);
+	msws::rng rng(42U);
+	for (size_t i = 0U; i < lines; ++i)
+	{
+		order[i] = i;
+	}
+	for (size_t i = lines - 1U; i > 0U; --i)
+	{
+		const size_t j = rng.uint32((uint32_t)(i + 1U));
+		const size_t tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+	}
+	for (size_t i = 0U; i < lines; ++i)
+	{
+		chain[order[i] * stride] = order[(i + 1U) % lines] * stride;
+	}
+}
+
+static double walk(const std::vector<size_t> &chain)
+{
+	const size_t lines = chain.size() / (LINE_SIZE / sizeof(size_t));
+	const clk::time_point start = clk::now();
+	volatile size_t pos = 0U;
+	size_t next = 0U;
+	for (size_t i = 0U; i < lines; ++i)
+	{
+		next = chain[next];
+	}
+	pos = next;
+	return elapsed(start) * 1e9 / lines;
+}
+
+static double idle(const std::vector<size_t> &chain, const double duration)
+{
+	const clk::time_point start = clk::now();
+	volatile uint64_t spin = 1U;
+	while (elapsed(start) < duration)
+	{
+		spin = spin * 3U + 1U;
+	}
+	return walk(chain);
+}
+
+template<class T>
+static void run(const char *const name, std::vector<size_t> &chain, std::vector<uint8_t> &buffer, const bool nt)
+{
+	T rng(42U);
+	double fill = 0.0, access = 0.0, control = 0.0;
+	static const int ROUNDS = 5;
+	for (int round = 0; round < ROUNDS; ++round)
+	{
+		walk(chain);
+		walk(chain);
+		const clk::time_point start = clk::now();
+		if (nt)
+		{
+			rng.bytes_nt(buffer.data(), buffer.size());
+		}
+		else
+		{
+			rng.bytes(buffer.data(), buffer.size());
+		}
+		const double duration = elapsed(start);
+		access += walk(chain);
+		walk(chain);
+		control += idle(chain, duration);
+		fill += duration;
+	}
+	printf("%-8s %-9s %9.2f %12.2f %12.2f\n", name, nt ? "bytes_nt" : "bytes", (ROUNDS * (double)buffer.size()) / fill / 1e9, access / ROUNDS, control / ROUNDS);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t fill_size = ((argc > 1) ? (size_t)atoll(argv[1]) : 256U) << 20U;
+	const size_t work_size = ((argc > 2) ? (size_t)atoll(argv[2]) : 1024U) << 10U;
+
+	if ((fill_size < 1U) || (work_size < LINE_SIZE))
+	{
+		fprintf(stderr, "Usage: %s [<fill MiB> [<working set KiB>]]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<uint8_t> buffer(fill_size);
+	std::vector<size_t> chain(work_size / sizeof(size_t));
+	memset(buffer.data(), 0, buffer.size());
+	mkchain(chain);
+
+	printf("Kernel: %s, fill: %zu MiB, working set: %zu KiB\n\n", msws::kernel(), fill_size >> 20U, work_size >> 10U);
+	printf("%-8s %-9s %9s %12s %12s\n", "engine", "mode", "fill GB/s", "ns/access", "idle ns/acc");
+	printf("%-8s %-9s %9s %12.2f %12s\n", "-", "(warm)", "-", (walk(chain), walk(chain)), "-");
+
+	run<msws::rng>("rng", chain, buffer, false);
+	run<msws::rng>("rng", chain, buffer, true);
+	run<msws::rng_x32>("rng_x32", chain, buffer, false);
+	run<msws::rng_x32>("rng_x32", chain, buffer, true);
+
+	return EXIT_SUCCESS;
+}
@@ -44,6 +44,25 @@
 *  4. Improved initialization (seeding) function                           *
 *  5. Made all functions thread-safe by avoiding the use of static vars    *
 *  6. Implemented C++ wrapper class, for convenience                       *
+*  7. Added multi-stream generator that interleaves independent states     *
+*  8. Added SIMD kernels (SSE4.1, AVX2, AVX-512) with runtime dispatch     *
+*  9. Unbiased, division-free bounded values (multiply-shift + rejection)  *
+*  10. Batch bounded values: SIMD multiply-high, compaction and refill     *
+*  11. Added 64-Bit output variant (128-Bit state, one round per value)    *
+*  12. Added counter-based "squares" generator (random access by index)    *
+*  13. Added stream-key generator and per-stream seeding (seed, stream)    *
+*  14. Batch initialization of many contexts, warm-up rounds in SIMD       *
+*  15. Added structure-of-arrays generator bank (one stream per element)   *
+*  16. Full 64-Bit seeds and faster (seed, stream) key expansion           *
+*  17. Added standard UniformRandomBitGenerator engine with block buffer   *
+*  18. Added asynchronous generator (producer thread, lock-free SPSC ring) *
+*  19. Added thread-local generators with unique per-thread streams        *
+*  20. Added lock-free shared generator (counter-based, one fetch_add)     *
+*  21. Parallel buffer fill, output independent of the number of threads   *
+*  22. Multi-threaded binary output in the CLI, with an ordered writer     *
+*  23. Optional zero-copy vmsplice() output into pipes on Linux            *
+*  24. File output through io_uring (optional O_DIRECT), pwrite() fallback *
+*  25. Generator and output threads in the CLI, tunable block size         *
 *                                                                          *
 \**************************************************************************/
 
@@ -69,7 +88,12 @@
 #include <time.h>
 #include <fcntl.h>
 
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
 #include "msws.h"
+#include "output.h"
 
 static const uint16_t VERSION[3] = { 1U, 0U, 0U };
 static const uint32_t INFINITE = 0U;
@@ -82,29 +106,198 @@ static const char *file_name(const char *path)
 	return path;
 }
 
-static uint32_t mkseed(void)
+static uint64_t mkseed(void)
 {
-	uint32_t seed = 0x8FF46D8E;
+	uint64_t seed = 0x8FF46D8E2B35C7A1;
 #ifdef _MSC_VER
-	rand_s(&seed);
+	uint32_t word;
+	if (!rand_s(&word)) seed = (seed << 32U) ^ word;
+	if (!rand_s(&word)) seed = (seed << 32U) ^ word;
 #endif
 #ifdef __linux__
 	const int fd = open("/dev/urandom", O_RDONLY);
 	if(fd >= 0)
 	{
-		size_t rd = read(fd, &seed, sizeof(uint32_t));
+		size_t rd = read(fd, &seed, sizeof(uint64_t));
 		close(fd);
 	}
 #endif
-	seed ^= (((uint32_t)time(NULL)) << 16U);
-	seed ^= (((uint32_t)GETPID()) & 0xFFFF);
+	seed ^= (((uint64_t)time(NULL)) << 32U);
+	seed ^= (((uint64_t)GETPID()) & 0xFFFFFFFF);
 	return seed;
 }
 
+static uint64_t parse_seed(const char *const str)
+{
+	if (str[strspn(str, " \t")] == '-')
+	{
+		return (uint32_t)strtoll(str, NULL, 10); /*negative seeds are reduced to 32-Bit, as in earlier versions*/
+	}
+	return (uint64_t)strtoull(str, NULL, 10);
+}
+
+static bool write_threaded(output_t *const out, const uint64_t seed, const uint32_t cntr, unsigned threads)
+{
+	static const size_t CHUNK_SIZE = MSWS_PARALLEL_CHUNK;
+	if (!threads)
+	{
+		threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1U;
+	}
+
+	const uint64_t lag = output_lag(out, CHUNK_SIZE);
+	const size_t slots = 2U * threads + (size_t)lag;
+	const uint64_t total = (cntr != INFINITE) ? ((((uint64_t)cntr) + CHUNK_SIZE - 1U) / CHUNK_SIZE) : UINT64_MAX;
+	uint8_t *const storage = output_storage(out, slots * CHUNK_SIZE);
+	if (!storage)
+	{
+		fprintf(stderr, "Failed to allocate output buffers!\n");
+		return false;
+	}
+	std::vector<uint64_t> ready(slots, UINT64_MAX);
+	std::mutex mutex;
+	std::condition_variable cond;
+	uint64_t next = 0U, written = 0U;
+	bool stop = false;
+
+	const auto block_size = [&](const uint64_t block)
+	{
+		return ((cntr != INFINITE) && ((block + 1U) * CHUNK_SIZE > cntr)) ? (size_t)(cntr - (block * CHUNK_SIZE)) : CHUNK_SIZE;
+	};
+
+	const auto worker = [&](void)
+	{
+		msws::impl::msws_x32_t ctx;
+		for (;;)
+		{
+			uint64_t block;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cond.wait(lock, [&] { return stop || (next >= total) || (next < written + slots); });
+				if (stop || (next >= total))
+				{
+					return;
+				}
+				block = next++;
+			}
+			msws::impl::msws_x32_init_stream(&ctx, seed, block);
+			msws::impl::msws_x32_bytes(&ctx, &storage[(block % slots) * CHUNK_SIZE], block_size(block));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				ready[block % slots] = block;
+			}
+			cond.notify_all();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned i = 0U; i < threads; ++i)
+	{
+		pool.push_back(std::thread(worker));
+	}
+
+	for (uint64_t block = 0U; block < total; ++block)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait(lock, [&] { return ready[block % slots] == block; });
+		}
+		const size_t bytes = block_size(block);
+		if (!output_write(out, &storage[(block % slots) * CHUNK_SIZE], bytes))
+		{
+			break; /*EOF*/
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			written = (block + 1U > lag) ? (block + 1U - lag) : 0U;
+		}
+		cond.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	cond.notify_all();
+	for (size_t i = 0U; i < pool.size(); ++i)
+	{
+		pool[i].join();
+	}
+	return true;
+}
+
+static bool write_pipelined(output_t *const out, msws::rng &rng, const uint32_t cntr)
+{
+	const size_t size = out->size, slots = 2U + output_lag(out, size);
+	const uint64_t lag = slots - 2U, total = (cntr != INFINITE) ? ((((uint64_t)cntr) + size - 1U) / size) : UINT64_MAX;
+	uint8_t *const storage = output_storage(out, slots * size);
+	if (!storage)
+	{
+		fprintf(stderr, "Failed to allocate output buffers!\n");
+		return false;
+	}
+	std::mutex mutex;
+	std::condition_variable cond;
+	uint64_t generated = 0U, written = 0U;
+	bool stop = false;
+
+	const auto block_size = [&](const uint64_t block)
+	{
+		return ((cntr != INFINITE) && ((block + 1U) * size > cntr)) ? (size_t)(cntr - (block * size)) : size;
+	};
+
+	std::thread generator([&](void)
+	{
+		for (uint64_t block = 0U; block < total; ++block)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cond.wait(lock, [&] { return stop || (block < written + slots); });
+				if (stop)
+				{
+					return;
+				}
+			}
+			rng.bytes(&storage[(block % slots) * size], block_size(block));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				generated = block + 1U;
+			}
+			cond.notify_all();
+		}
+	});
+
+	for (uint64_t block = 0U; block < total; ++block)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait(lock, [&] { return generated > block; });
+		}
+		if (!output_write(out, &storage[(block % slots) * size], block_size(block)))
+		{
+			break; /*EOF*/
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			written = (block + 1U > lag) ? (block + 1U - lag) : 0U;
+		}
+		cond.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	cond.notify_all();
+	generator.join();
+	return true;
+}
+
 int main(int argc, char *argv[])
 {
-	bool hex_format = true;
-	int arg_offset = 1, rnd_mode = 0;
+	bool hex_format = true, direct = false, splice = false;
+	const char *output_path = NULL;
+	size_t buffer_size = 0U;
+	int arg_offset = 1, rnd_mode = 0, threads = -1;
 
 #ifdef _MSC_VER
 	_setmode(_fileno(stdout), _O_BINARY);
@@ -127,13 +320,25 @@ int main(int argc, char *argv[])
 		printf("Switches:\n");
 		printf("   --uint64 : Output unsigned 64-Bit numeric values (default: unsigned 32-Bit)\n");
 		printf("   --decfmt : Output numeric values in decimal format (default: hexadecimal)\n");
-		printf("   --binary : Output stream of \"raw\" bytes instead of printing numeric values\n\n");
+		printf("   --binary : Output stream of \"raw\" bytes instead of printing numeric values\n");
+		printf("   --threads <n> : Generate the \"raw\" bytes on <n> threads (0 = all cores)\n");
+		printf("   --output <path> : Write the \"raw\" bytes to a file or device (via io_uring)\n");
+		printf("   --direct : Bypass the page cache when writing to <path> (O_DIRECT)\n");
+		printf("   --buffer <size> : Set the size of the \"raw\" output blocks, in bytes\n");
+		printf("   --splice : Zero-copy output into a pipe on stdout (Linux, vmsplice)\n\n");
 		printf("Options:\n");
 		printf("   <count> : Set the number of values or bytes to generate (default: infinite)\n");
-		printf("   <seed>  : Set the value to seed the PRNG (default: seed from system RNG)\n\n");
+		printf("   <seed>  : Set the 64-Bit value to seed the PRNG (default: seed from system RNG)\n\n");
 		printf("NOTE: The same 'seed' value always re-generates the same sequence. Use\n");
 		printf("different 'seed' values to generate different sequences. If the 'seed' value\n");
-		printf("is *not* specified, a pseudo-random 'seed' is requested from the system.\n\n");
+		printf("is *not* specified, a pseudo-random 'seed' is requested from the system.\n");
+		printf("Seeds up to 4294967295 (and negative seeds) give the same sequence as earlier\n");
+		printf("versions, which reduced every seed to 32-Bit; larger seeds now differ.\n");
+		printf("With '--threads' the byte stream differs from the single-threaded one, but it\n");
+		printf("is the same for any number of threads (blocks are always 1 MiB, so --buffer is\n");
+		printf("not available with '--threads'). The --buffer size never changes the stream.\n");
+		printf("With '--splice' the reader of the pipe must read() the data. Readers that\n");
+		printf("splice() it on (e.g. 'pv') would see corrupted data; put 'cat' in between.\n\n");
 		return EXIT_SUCCESS;
 	}
 
@@ -153,6 +358,51 @@ int main(int argc, char *argv[])
 				arg_offset = i + 1;
 				continue;
 			}
+			else if ((!strcmp(argv[i], "--threads")) && (i + 1 < argc))
+			{
+				char *end = NULL;
+				const long value = strtol(argv[++i], &end, 10);
+				if ((end == argv[i]) || (*end) || (value < 0L) || (value > 65536L))
+				{
+					fprintf(stderr, "Bad argument: %s %s\n", argv[i - 1], argv[i]);
+					return EXIT_FAILURE;
+				}
+				threads = (int)value;
+				arg_offset = i + 1;
+				continue;
+			}
+			else if ((!strcmp(argv[i], "--output")) && (i + 1 < argc))
+			{
+				output_path = argv[++i];
+				arg_offset = i + 1;
+				continue;
+			}
+			else if ((!strcmp(argv[i], "--buffer")) && (i + 1 < argc))
+			{
+				char *end = NULL;
+				const char *const value = argv[++i];
+				const unsigned long long size = strtoull(value, &end, 10);
+				if ((value[strspn(value, " \t")] == '-') || (end == value) || (*end) || (size < 1ULL) || (size > OUTPUT_MAX_SIZE))
+				{
+					fprintf(stderr, "Bad argument: %s %s\n", argv[i - 1], value);
+					return EXIT_FAILURE;
+				}
+				buffer_size = (size_t)size;
+				arg_offset = i + 1;
+				continue;
+			}
+			else if (!strcmp(argv[i], "--splice"))
+			{
+				splice = true;
+				arg_offset = i + 1;
+				continue;
+			}
+			else if (!strcmp(argv[i], "--direct"))
+			{
+				direct = true;
+				arg_offset = i + 1;
+				continue;
+			}
 			else if (!strcmp(argv[i], "--decfmt"))
 			{
 				hex_format = false;
@@ -169,7 +419,31 @@ int main(int argc, char *argv[])
 	}
 
 	const uint32_t cntr = (argc > arg_offset) ? (uint32_t)atoll(argv[arg_offset++]) : INFINITE;
-	const uint32_t seed = (argc > arg_offset) ? (uint32_t)atoll(argv[arg_offset++]) : mkseed();
+	const uint64_t seed = (argc > arg_offset) ? parse_seed(argv[arg_offset++]) : mkseed();
+
+	if ((threads >= 0) && (rnd_mode != 2))
+	{
+		fprintf(stderr, "The --threads switch requires --binary\n");
+		return EXIT_FAILURE;
+	}
+
+	if ((output_path && (rnd_mode != 2)) || (direct && (!output_path)))
+	{
+		fprintf(stderr, output_path ? "The --output switch requires --binary\n" : "The --direct switch requires --output\n");
+		return EXIT_FAILURE;
+	}
+
+	if (splice && ((rnd_mode != 2) || output_path))
+	{
+		fprintf(stderr, output_path ? "The --splice switch can not be combined with --output\n" : "The --splice switch requires --binary\n");
+		return EXIT_FAILURE;
+	}
+
+	if (buffer_size && ((rnd_mode != 2) || (threads >= 0)))
+	{
+		fprintf(stderr, (threads >= 0) ? "The --buffer switch can not be combined with --threads\n" : "The --buffer switch requires --binary\n");
+		return EXIT_FAILURE;
+	}
 
 	msws::rng rng(seed);
 	
@@ -209,31 +483,25 @@ int main(int argc, char *argv[])
 		break;
 	case 2:
 		{
-			static const size_t BUFF_SIZE = 4096;
-			uint8_t buffer[BUFF_SIZE];
-			if (cntr == INFINITE)
+			output_t out;
+			if (!output_path)
 			{
-				for (;;)
-				{
-					rng.bytes(buffer, BUFF_SIZE);
-					if (fwrite(buffer, sizeof(uint8_t), BUFF_SIZE, stdout) != BUFF_SIZE)
-					{
-						break; /*EOF*/
-					}
-				}
+				output_open(&out, buffer_size, splice);
 			}
-			else
+			else if (!output_open_file(&out, output_path, buffer_size, direct))
 			{
-				uint32_t remain = cntr, bytes = 0U;
-				do
-				{
-					rng.bytes(buffer, bytes = (remain > BUFF_SIZE) ? BUFF_SIZE : remain);
-					if (fwrite(buffer, sizeof(uint8_t), bytes, stdout) != bytes)
-					{
-						break; /*EOF*/
-					}
-				}
-				while ((remain -= bytes) > 0U);
+				fprintf(stderr, "Failed to open output file: %s\n", output_path);
+				return EXIT_FAILURE;
+			}
+			const bool done = (threads >= 0) ? write_threaded(&out, seed, cntr, (unsigned)threads) : write_pipelined(&out, rng, cntr);
+			if ((!output_close(&out)) && output_path)
+			{
+				fprintf(stderr, "Failed to write output file: %s\n", output_path);
+				return EXIT_FAILURE;
+			}
+			if (!done)
+			{
+				return EXIT_FAILURE;
 			}
 		}
 		break;
@@ -0,0 +1,507 @@
+/**************************************************************************\
+*                                                                          *
+*  Middle Square Weyl Sequence Random Number Generator                     *
+*                                                                          *
+*  Output backends for the "raw" bytes mode of the command-line tool       *
+*                                                                          *
+*  The caller generates blocks into the buffer from output_storage(), and  *
+*  must not modify a block until output_lag() more blocks have been passed *
+*  to output_write(). The buffer is freed by output_close(), once all the  *
+*  writes have completed. By default, blocks are written with plain stdio. *
+*  On Linux, if stdout is a pipe, the pipe is enlarged. If requested, the  *
+*  pages of each block are then mapped into it with vmsplice(), so that    *
+*  the data is not copied. The pipe references the pages until the reader  *
+*  has consumed them, i.e. until a full pipe of data followed them. This   *
+*  only holds for readers that use read(): a reader that splice()s the     *
+*  data on (e.g. to a socket) keeps referencing the pages after they left  *
+*  the pipe, so it would see later data. Hence splicing is opt-in.         *
+*                                                                          *
+*  Files (and block devices) are written through io_uring, so that the     *
+*  next block is generated while up to OUTPUT_INFLIGHT writes are still in *
+*  flight. Without io_uring, the blocks are written with pwrite().         *
+*                                                                          *
+*  Copyright (c) 2017 LoRd_MuldeR <mulder2@gmx.de>                         *
+*                                                                          *
+*  This code can be used under the terms of the GNU General Public License *
+*  as published by the Free Software Foundation, either version 3 of the   *
+*  License, or any later version. See the GPL license at URL               *
+*  http://www.gnu.org/licenses                                             *
+*                                                                          *
+\**************************************************************************/
+
+#ifndef _INC_OUTPUT_H
+#define _INC_OUTPUT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define OUTPUT_URING 1
+#endif
+#endif
+#endif
+
+#define OUTPUT_INFLIGHT 4U
+#define OUTPUT_PAGE_SIZE 4096U
+#define OUTPUT_STDIO_SIZE (1U << 16U)
+#define OUTPUT_PIPE_SIZE (1U << 20U)
+#define OUTPUT_FILE_SIZE (1U << 20U)
+#define OUTPUT_MAX_SIZE (1U << 30U)
+
+typedef enum
+{
+	OUTPUT_STDIO,
+	OUTPUT_SPLICE,
+	OUTPUT_PWRITE,
+	OUTPUT_IO_URING
+}
+output_mode_t;
+
+#ifdef OUTPUT_URING
+
+typedef struct
+{
+	int fd;
+	uint32_t *sq_head, *sq_tail, *sq_mask, *sq_array;
+	uint32_t *cq_head, *cq_tail, *cq_mask;
+	void *sq_ring, *cq_ring;
+	size_t sq_size, cq_size, sqes_size;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+}
+output_ring_t;
+
+#endif //OUTPUT_URING
+
+typedef struct
+{
+	output_mode_t mode;
+	FILE *file;
+	int fd;
+	bool direct, failed;
+	size_t size, capacity, next;
+	uint64_t offset;
+	uint8_t *storage;
+#ifdef OUTPUT_URING
+	output_ring_t ring;
+	bool busy[OUTPUT_INFLIGHT];
+	const uint8_t *data[OUTPUT_INFLIGHT];
+	size_t length[OUTPUT_INFLIGHT];
+	uint64_t position[OUTPUT_INFLIGHT];
+#endif
+}
+output_t;
+
+static uint8_t *output_alloc(const size_t size)
+{
+#ifdef _MSC_VER
+	return (uint8_t*)_aligned_malloc(size, OUTPUT_PAGE_SIZE);
+#else
+	void *ptr = NULL;
+	return posix_memalign(&ptr, OUTPUT_PAGE_SIZE, size) ? NULL : (uint8_t*)ptr;
+#endif
+}
+
+static void output_free(uint8_t *const ptr)
+{
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+/* ------------------------------------------------------------------------ */
+/* Synchronous writes                                                       */
+/* ------------------------------------------------------------------------ */
+
+#ifdef __linux__
+
+static bool output_pwrite(output_t *const out, const uint8_t *data, size_t len, uint64_t offset)
+{
+	if (out->direct && (len % OUTPUT_PAGE_SIZE))
+	{
+		out->direct = false; /*the final, partial block can not be written with O_DIRECT*/
+		fcntl(out->fd, F_SETFL, fcntl(out->fd, F_GETFL) & (~O_DIRECT));
+	}
+	while (len > 0U)
+	{
+		const ssize_t done = pwrite(out->fd, data, len, (off_t)offset);
+		if (done <= 0)
+		{
+			if ((done < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			return false;
+		}
+		data += done; len -= (size_t)done; offset += (uint64_t)done;
+	}
+	return true;
+}
+
+#endif //__linux__
+
+/* ------------------------------------------------------------------------ */
+/* io_uring (raw system calls, no liburing required)                        */
+/* ------------------------------------------------------------------------ */
+
+#ifdef OUTPUT_URING
+
+static void output_ring_exit(output_ring_t *const ring)
+{
+	if (ring->sqes)
+	{
+		munmap(ring->sqes, ring->sqes_size);
+	}
+	if (ring->cq_ring && (ring->cq_ring != ring->sq_ring))
+	{
+		munmap(ring->cq_ring, ring->cq_size);
+	}
+	if (ring->sq_ring)
+	{
+		munmap(ring->sq_ring, ring->sq_size);
+	}
+	if (ring->fd >= 0)
+	{
+		close(ring->fd);
+	}
+	memset(ring, 0, sizeof(output_ring_t));
+	ring->fd = -1;
+}
+
+static bool output_ring_init(output_ring_t *const ring, const uint32_t entries)
+{
+	struct io_uring_params params;
+	memset(ring, 0, sizeof(output_ring_t));
+	memset(&params, 0, sizeof(params));
+	if ((ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params)) < 0)
+	{
+		return false;
+	}
+
+	ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		ring->sq_size = ring->cq_size = (ring->sq_size > ring->cq_size) ? ring->sq_size : ring->cq_size;
+	}
+
+	void *ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	if (ptr == MAP_FAILED)
+	{
+		output_ring_exit(ring);
+		return false;
+	}
+	ring->sq_ring = ring->cq_ring = ptr;
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+	{
+		if ((ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING)) == MAP_FAILED)
+		{
+			ring->cq_ring = NULL;
+			output_ring_exit(ring);
+			return false;
+		}
+		ring->cq_ring = ptr;
+	}
+
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	if ((ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES)) == MAP_FAILED)
+	{
+		output_ring_exit(ring);
+		return false;
+	}
+	ring->sqes = (struct io_uring_sqe*)ptr;
+
+	uint8_t *const sq = (uint8_t*)ring->sq_ring, *const cq = (uint8_t*)ring->cq_ring;
+	ring->sq_head = (uint32_t*)(sq + params.sq_off.head);
+	ring->sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+	ring->sq_mask = (uint32_t*)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (uint32_t*)(sq + params.sq_off.array);
+	ring->cq_head = (uint32_t*)(cq + params.cq_off.head);
+	ring->cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+	ring->cq_mask = (uint32_t*)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+	return true;
+}
+
+static bool output_ring_submit(output_ring_t *const ring, const int fd, const uint8_t *const data, const size_t len, const uint64_t offset, const uint64_t user_data)
+{
+	const uint32_t tail = *ring->sq_tail, index = tail & (*ring->sq_mask);
+	struct io_uring_sqe *const sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = IORING_OP_WRITE;
+	sqe->fd = fd;
+	sqe->off = offset;
+	sqe->addr = (uint64_t)(uintptr_t)data;
+	sqe->len = (uint32_t)len;
+	sqe->user_data = user_data;
+	ring->sq_array[index] = index;
+	__atomic_store_n(ring->sq_tail, tail + 1U, __ATOMIC_RELEASE);
+	for (;;)
+	{
+		const long submitted = syscall(__NR_io_uring_enter, ring->fd, 1U, 0U, 0U, NULL, 0U);
+		if (submitted == 1L)
+		{
+			return true;
+		}
+		if ((submitted < 0L) && (errno == EINTR))
+		{
+			continue;
+		}
+		if (__atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == tail)
+		{
+			__atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE); /*not consumed, must not be sent with the next one*/
+		}
+		return false;
+	}
+}
+
+static bool output_ring_reap(output_ring_t *const ring, uint64_t *const user_data, int32_t *const result)
+{
+	const uint32_t head = *ring->cq_head;
+	while (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+	{
+		if ((syscall(__NR_io_uring_enter, ring->fd, 0U, 1U, IORING_ENTER_GETEVENTS, NULL, 0U) < 0) && (errno != EINTR))
+		{
+			return false;
+		}
+	}
+	const struct io_uring_cqe *const cqe = &ring->cqes[head & (*ring->cq_mask)];
+	*user_data = cqe->user_data;
+	*result = cqe->res;
+	__atomic_store_n(ring->cq_head, head + 1U, __ATOMIC_RELEASE);
+	return true;
+}
+
+static void output_ring_wait(output_t *const out, const size_t slot)
+{
+	while (out->busy[slot])
+	{
+		uint64_t done;
+		int32_t result;
+		if (!output_ring_reap(&out->ring, &done, &result))
+		{
+			out->failed = true;
+			memset(out->busy, 0, sizeof(out->busy));
+			return;
+		}
+		out->busy[done] = false;
+		if ((result < 0) || ((size_t)result < out->length[done]))
+		{
+			const size_t skip = (result > 0) ? (size_t)result : 0U; /*short or failed write, finish synchronously*/
+			if (!output_pwrite(out, out->data[done] + skip, out->length[done] - skip, out->position[done] + skip))
+			{
+				out->failed = true;
+			}
+		}
+	}
+}
+
+static void output_ring_flush(output_t *const out)
+{
+	for (size_t i = 0U; i < OUTPUT_INFLIGHT; ++i)
+	{
+		output_ring_wait(out, i);
+	}
+}
+
+#endif //OUTPUT_URING
+
+/* ------------------------------------------------------------------------ */
+/* Public interface                                                         */
+/* ------------------------------------------------------------------------ */
+
+static bool output_close(output_t *const out)
+{
+	switch (out->mode)
+	{
+#ifdef OUTPUT_URING
+	case OUTPUT_IO_URING:
+		output_ring_flush(out);
+		output_ring_exit(&out->ring);
+		close(out->fd);
+		break;
+#endif
+#ifdef __linux__
+	case OUTPUT_PWRITE:
+		close(out->fd);
+		break;
+#endif
+	default:
+		fflush(out->file);
+		if (out->file != stdout)
+		{
+			fclose(out->file);
+		}
+		break;
+	}
+	output_free(out->storage); /*only now no write can reference it anymore*/
+	out->storage = NULL;
+	return !out->failed;
+}
+
+static uint8_t *output_storage(output_t *const out, const size_t size)
+{
+	output_free(out->storage);
+	return (out->storage = output_alloc(size));
+}
+
+static size_t output_block_size(const size_t size, const size_t fallback)
+{
+	if ((!size) || (size > OUTPUT_MAX_SIZE))
+	{
+		return fallback;
+	}
+	return ((size + OUTPUT_PAGE_SIZE - 1U) / OUTPUT_PAGE_SIZE) * OUTPUT_PAGE_SIZE;
+}
+
+static void output_open(output_t *const out, const size_t size, const bool splice)
+{
+	memset(out, 0, sizeof(output_t));
+	out->mode = OUTPUT_STDIO;
+	out->file = stdout;
+	out->fd = fileno(stdout);
+	out->size = output_block_size(size, OUTPUT_STDIO_SIZE);
+#ifdef __linux__
+	struct stat info;
+	if ((!fstat(out->fd, &info)) && S_ISFIFO(info.st_mode))
+	{
+		fcntl(out->fd, F_SETPIPE_SZ, (int)OUTPUT_PIPE_SIZE);
+		const int pipe_size = fcntl(out->fd, F_GETPIPE_SZ);
+		if (splice && (pipe_size > 0))
+		{
+			out->mode = OUTPUT_SPLICE;
+			out->capacity = (size_t)pipe_size;
+			out->size = output_block_size(size, out->capacity);
+		}
+	}
+#endif
+}
+
+static bool output_open_file(output_t *const out, const char *const path, const size_t size, const bool direct)
+{
+	memset(out, 0, sizeof(output_t));
+	out->size = output_block_size(size, OUTPUT_FILE_SIZE);
+#ifdef __linux__
+	out->direct = direct;
+	if ((out->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | (direct ? O_DIRECT : 0), 0666)) < 0)
+	{
+		return false;
+	}
+	out->mode = OUTPUT_PWRITE;
+#ifdef OUTPUT_URING
+	if (output_ring_init(&out->ring, 2U * OUTPUT_INFLIGHT))
+	{
+		out->mode = OUTPUT_IO_URING;
+	}
+#endif
+#else
+	if (direct || (!(out->file = fopen(path, "wb"))))
+	{
+		return false;
+	}
+	out->mode = OUTPUT_STDIO;
+	out->fd = fileno(out->file);
+#endif
+	return true;
+}
+
+static size_t output_lag(const output_t *const out, const size_t block)
+{
+	switch (out->mode)
+	{
+	case OUTPUT_SPLICE:
+		return (out->capacity + block - 1U) / block; /*spliced pages stay referenced until a full pipe follows*/
+	case OUTPUT_IO_URING:
+		return OUTPUT_INFLIGHT; /*a write may still be in flight until OUTPUT_INFLIGHT more were queued*/
+	default:
+		return 0U;
+	}
+}
+
+static bool output_write(output_t *const out, const uint8_t *data, size_t len)
+{
+	const size_t slot = out->next;
+	out->next = (out->next + 1U) % OUTPUT_INFLIGHT;
+	switch (out->mode)
+	{
+#ifdef OUTPUT_URING
+	case OUTPUT_IO_URING:
+		output_ring_wait(out, slot);
+		if (out->failed)
+		{
+			return false;
+		}
+		if (!(out->direct && (len % OUTPUT_PAGE_SIZE)))
+		{
+			out->data[slot] = data;
+			out->length[slot] = len;
+			out->position[slot] = out->offset;
+			if (output_ring_submit(&out->ring, out->fd, data, len, out->offset, slot))
+			{
+				out->busy[slot] = true;
+				out->offset += len;
+				return true;
+			}
+		}
+		output_ring_flush(out);
+		break;
+#endif
+#ifdef __linux__
+	case OUTPUT_SPLICE:
+		while (len > 0U)
+		{
+			struct iovec iov;
+			iov.iov_base = (void*)data;
+			iov.iov_len = len;
+			const ssize_t done = vmsplice(out->fd, &iov, 1U, 0U);
+			if (done < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				if (errno == EPIPE)
+				{
+					return false;
+				}
+				out->mode = OUTPUT_STDIO; /*not supported, fall back*/
+				break;
+			}
+			data += done; len -= (size_t)done;
+		}
+		return (fwrite(data, sizeof(uint8_t), len, out->file) == len);
+	case OUTPUT_PWRITE:
+		break;
+#endif
+	default:
+		return (fwrite(data, sizeof(uint8_t), len, out->file) == len);
+	}
+#ifdef __linux__
+	if (out->failed || (!output_pwrite(out, data, len, out->offset)))
+	{
+		return !(out->failed = true);
+	}
+	out->offset += len;
+#endif
+	return true;
+}
+
+#endif //_INC_OUTPUT_H